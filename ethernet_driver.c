@@ -21,6 +21,7 @@
  *      Author: Alex Manoel Ferreira Silva
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -33,6 +34,7 @@
 #endif // CONFIG_ETH_USE_SPI_ETHERNET
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #include "esp_eth.h"
@@ -42,6 +44,7 @@
 #include "esp_log.h"
 #include "esp_err.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
 #include "esp_netif_types.h"
 #include "esp_netif_defaults.h"
 #include "esp_eth_mac.h"
@@ -50,9 +53,23 @@
 #include "log_utils.h"
 
 #include "ethernet_driver.h"
+#include "ethernet_driver_failover.h"
+#include "ethernet_driver_spi_calibration.h"
 
 LOG_TAG("ethernet_driver");
 
+// esp_eth_stop() posts the STOP event, the netif is stopped when it is handled
+#define BRING_DOWN_STOP_TIMEOUT_MS 1000
+
+#if CONFIG_ETHERNET_DRIVER_TRACE
+static const ethernet_driver_trace_id_t s_eth_event_trace_ids[] = {
+	[ETHERNET_EVENT_START]        = ETHERNET_DRIVER_TRACE_START,
+	[ETHERNET_EVENT_STOP]         = ETHERNET_DRIVER_TRACE_STOP,
+	[ETHERNET_EVENT_CONNECTED]    = ETHERNET_DRIVER_TRACE_LINK_UP,
+	[ETHERNET_EVENT_DISCONNECTED] = ETHERNET_DRIVER_TRACE_LINK_DOWN,
+};
+#endif // CONFIG_ETHERNET_DRIVER_TRACE
+
 /** Event handler for Ethernet events */
 static void eth_event_handler(void *arg, esp_event_base_t event_base,
 							  int32_t event_id, void *event_data) {
@@ -60,6 +77,20 @@ static void eth_event_handler(void *arg, esp_event_base_t event_base,
 	/* we can get the ethernet driver handle from event data */
 	esp_eth_handle_t eth_handle = *(esp_eth_handle_t *)event_data;
 
+#if CONFIG_ETHERNET_DRIVER_TRACE
+	// Formatted later by the trace task, the event loop only copies
+	if (event_id < 0 || event_id > ETHERNET_EVENT_DISCONNECTED) {
+		return;
+	}
+
+	if (event_id == ETHERNET_EVENT_CONNECTED) {
+		esp_eth_ioctl(eth_handle, ETH_CMD_G_MAC_ADDR, mac_addr);
+	}
+
+	ethernet_driver_trace_write(
+		ethernet_driver_boot_find_index(NULL, eth_handle),
+		s_eth_event_trace_ids[event_id], mac_addr, sizeof(mac_addr));
+#else
 	switch (event_id) {
 		case ETHERNET_EVENT_CONNECTED:
 			esp_eth_ioctl(eth_handle, ETH_CMD_G_MAC_ADDR, mac_addr);
@@ -80,6 +111,7 @@ static void eth_event_handler(void *arg, esp_event_base_t event_base,
 		default:
 			break;
 	}
+#endif // CONFIG_ETHERNET_DRIVER_TRACE
 }
 
 /** Event handler for IP_EVENT_ETH_GOT_IP */
@@ -88,256 +120,1130 @@ static void got_ip_event_handler(void *arg, esp_event_base_t event_base,
 	ip_event_got_ip_t         *event   = (ip_event_got_ip_t *)event_data;
 	const esp_netif_ip_info_t *ip_info = &event->ip_info;
 
+#if CONFIG_ETHERNET_DRIVER_TRACE
+	// Address, netmask and gateway, 12 bytes in network byte order
+	ethernet_driver_trace_write(
+		ethernet_driver_boot_find_index(event->esp_netif, NULL),
+		ETHERNET_DRIVER_TRACE_GOT_IP, ip_info, sizeof(*ip_info));
+#else
 	LOGI("Ethernet Got IP Address");
 	LOGI("~~~~~~~~~~~");
 	LOGI("ETHIP:" IPSTR, IP2STR(&ip_info->ip));
 	LOGI("ETHMASK:" IPSTR, IP2STR(&ip_info->netmask));
 	LOGI("ETHGW:" IPSTR, IP2STR(&ip_info->gw));
 	LOGI("~~~~~~~~~~~");
+#endif // CONFIG_ETHERNET_DRIVER_TRACE
 }
 
-/*
-static void main_app(void) {
-	ethernet_driver_config_t config = {
-#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-		.internal_config = ETHERNET_DRIVER_CONFIG_INTERNAL_DEFAULT(),
-#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+/** Preallocate the frame buffers shared by one kind of interface */
+static esp_err_t init_frame_pool(ethernet_driver_frame_pool_t **frame_pool) {
+	return ethernet_driver_frame_pool_new(
+		CONFIG_ETHERNET_DRIVER_FRAME_POOL_BUFFERS, ETH_MAX_PACKET_SIZE,
+		frame_pool);
+}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+/**
+ * Live handles of one interface and what is left to bring it up, the only
+ * state the driver keeps per interface once the init returned
+ */
+typedef struct interface_s {
+	esp_netif_t                        *netif;
+	esp_eth_mac_t                      *eth_mac;
+	esp_eth_phy_t                      *eth_phy;
+	esp_eth_handle_t                    eth_handle;
+	ethernet_driver_netif_glue_handle_t netif_glue;
+	uint32_t                            index;
+	uint8_t                             mac_address[6];
+	bool                                set_mac_address;
+	bool                                used; // Slots of absent SPI modules
+	// Creates eth_mac and eth_phy in the bring-up from its copy of the config
+	esp_err_t (*create)(struct interface_s *interface);
+	void         *create_arg;
+	volatile bool bringing_up; // Deinit and restart refuse until it is done
+} interface_t;
+
+static interface_t s_interfaces[ETHERNET_DRIVER_ETHERNETS_NUM];
+static bool        s_initialized;
+
+#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && \
+	CONFIG_ETHERNET_DRIVER_FRAME_POOL
+static ethernet_driver_frame_pool_t *s_internal_frame_pool;
+#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && FRAME_POOL
+
 #if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
-		.spi_config = ETHERNET_DRIVER_CONFIG_SPI_DEFAULT(),
+// Freed by the deinit, the configuration is gone by then
+static spi_host_device_t s_spi_hosts[ETHERNET_DRIVER_SPI_BUSES_MAX];
+static uint8_t           s_spi_bus_num;
+// Left to its owner when another component installed it first
+static bool s_isr_service_installed;
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+static ethernet_driver_frame_pool_t *s_spi_frame_pool;
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
 #endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET && \
+	CONFIG_ETHERNET_DRIVER_FRAME_POOL
+static ethernet_driver_frame_pool_t *s_virtual_frame_pool;
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET && FRAME_POOL
+
+static const ethernet_driver_config_t s_default_config =
+	ETHERNET_DRIVER_CONFIG_DEFAULT();
+
+/**
+ * Netif of base, with if_key, if_desc and route_prio replaced unless
+ * if_key is NULL. esp-netif copies what it keeps, so nothing has to outlive
+ * the call.
+ */
+static esp_err_t init_netif(const esp_netif_inherent_config_t *base,
+							const char *if_key, const char *if_desc,
+							int route_prio, esp_netif_t **netif) {
+	esp_netif_inherent_config_t inherent_config =
+		*(base != NULL ? base : ESP_NETIF_BASE_DEFAULT_ETH);
+
+	if (if_key != NULL) {
+		inherent_config.if_key     = if_key;
+		inherent_config.if_desc    = if_desc;
+		inherent_config.route_prio = route_prio;
+	}
+
+	// Frames are handed to lwIP by the component netstack and netif glue
+	esp_netif_config_t netif_config = {
+		.base  = &inherent_config,
+		.stack = ETHERNET_DRIVER_NETSTACK_DEFAULT_ETH,
 	};
 
-#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-	config.internal_config.netif_config   = ESP_NETIF_DEFAULT_ETH();
-	config.internal_config.eth_mac_config = ETH_MAC_DEFAULT_CONFIG();
-	config.internal_config.eth_phy_config = ETH_PHY_DEFAULT_CONFIG();
-#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
-	config.spi_config.netif_inherent_config = ESP_NETIF_INHERENT_DEFAULT_ETH();
-	config.spi_config.netif_config          = ESP_NETIF_DEFAULT_ETH();
-	config.spi_config.eth_mac_config        = ETH_MAC_DEFAULT_CONFIG();
-	config.spi_config.eth_phy_config        = ETH_PHY_DEFAULT_CONFIG();
-#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+	*netif = esp_netif_new(&netif_config);
 
-	ethernet_driver_init(&config);
+	if (*netif == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	esp_err_t ret = ethernet_driver_netstack_bind(*netif);
+
+	if (ret != ESP_OK) {
+		esp_netif_destroy(*netif);
+		*netif = NULL;
+	}
+
+	return ret;
 }
-*/
 
-void ethernet_driver_init(ethernet_driver_config_t *config) {
-	// Initialize TCP/IP network interface (should be called only once in
-	// application)
-	ESP_ERROR_CHECK(esp_netif_init());
-	// Create default event loop that running in background
-	// ESP_ERROR_CHECK(esp_event_loop_create_default());
+/** Slot of interface index, its MAC and PHY are set or created after */
+static interface_t *init_interface(uint32_t index, esp_netif_t *netif,
+								   const uint8_t *mac_address) {
+	interface_t *interface = &s_interfaces[index];
+
+	interface->index           = index;
+	interface->netif           = netif;
+	interface->set_mac_address = mac_address != NULL;
+	interface->used            = true;
+
+	if (mac_address != NULL) {
+		memcpy(interface->mac_address, mac_address, 6);
+	}
+
+	return interface;
+}
+
+/** MAC and PHY of interface, then the hooks that need them */
+static esp_err_t create_interface(interface_t *interface) {
+	esp_err_t ret = ESP_OK;
+
+	if (interface->create != NULL) {
+		ret = interface->create(interface);
+
+		free(interface->create_arg);
+		interface->create     = NULL;
+		interface->create_arg = NULL;
+	}
+
+	if (ret == ESP_OK &&
+		(interface->eth_mac == NULL || interface->eth_phy == NULL)) {
+		ret = ESP_FAIL;
+	}
+
+#if CONFIG_ETHERNET_DRIVER_FAILOVER
+	// Before the driver is installed, which hands the PHY its mediator
+	if (ret == ESP_OK) {
+		ret = ethernet_driver_failover_attach(interface->index,
+											  interface->netif,
+											  interface->eth_phy,
+											  &interface->eth_handle);
+	}
+#endif // CONFIG_ETHERNET_DRIVER_FAILOVER
+
+	if (ret != ESP_OK) {
+		LOGE("Creation of interface %" PRIu32 " failed: %s",
+			 interface->index, esp_err_to_name(ret));
+		ethernet_driver_boot_failed(interface->index, ret);
+	}
+
+	return ret;
+}
+
+/** Install the driver, attach it to its netif and start it */
+static esp_err_t bring_up_interface(interface_t *interface) {
+	esp_eth_config_t eth_config =
+		ETH_DEFAULT_CONFIG(interface->eth_mac, interface->eth_phy);
+
+#if CONFIG_ETHERNET_DRIVER_FAILOVER_FAST_LINK_POLL
+	eth_config.check_link_period_ms =
+		CONFIG_ETHERNET_DRIVER_FAILOVER_LINK_POLL_MS;
+#endif // CONFIG_ETHERNET_DRIVER_FAILOVER_FAST_LINK_POLL
+
+	esp_err_t ret = esp_eth_driver_install(&eth_config, &interface->eth_handle);
+
+	if (ret == ESP_OK && interface->set_mac_address) {
+		ret = esp_eth_ioctl(interface->eth_handle, ETH_CMD_S_MAC_ADDR,
+							interface->mac_address);
+	}
+
+	if (ret == ESP_OK) {
+		ethernet_driver_boot_register(interface->index, interface->netif,
+									  interface->eth_handle);
+
+		// attach Ethernet driver to TCP/IP stack
+		interface->netif_glue = ethernet_driver_netif_glue_new(
+			interface->eth_handle, interface->index);
+
+		ret = interface->netif_glue == NULL
+				? ESP_ERR_NO_MEM
+				: esp_netif_attach(interface->netif, interface->netif_glue);
+	}
+
+	if (ret == ESP_OK) {
+		ret = esp_eth_start(interface->eth_handle);
+	}
+
+	if (ret != ESP_OK) {
+		LOGE("Bring-up of interface %" PRIu32 " failed: %s",
+			 interface->index, esp_err_to_name(ret));
+		ethernet_driver_boot_failed(interface->index, ret);
+	}
+
+	return ret;
+}
+
+typedef struct bring_down_s {
+	esp_eth_handle_t  eth_handle;
+	SemaphoreHandle_t stopped;
+} bring_down_t;
+
+static void bring_down_stop_handler(void *arg, esp_event_base_t event_base,
+									int32_t event_id, void *event_data) {
+	bring_down_t *bring_down = arg;
+
+	if (*(esp_eth_handle_t *)event_data == bring_down->eth_handle) {
+		xSemaphoreGive(bring_down->stopped);
+	}
+}
+
+/** Undo bring_up_interface(), the MAC, PHY and netif are kept */
+static esp_err_t bring_down_interface(interface_t *interface) {
+	esp_event_handler_instance_t instance = NULL;
+	bring_down_t                 bring_down;
+
+	bring_down.eth_handle = interface->eth_handle;
+	bring_down.stopped    = xSemaphoreCreateBinary();
+
+	if (bring_down.stopped == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	// Registered after the glue's, so the netif is stopped once it runs
+	esp_err_t ret = esp_event_handler_instance_register(
+		ETH_EVENT, ETHERNET_EVENT_STOP, bring_down_stop_handler, &bring_down,
+		&instance);
+
+	if (ret == ESP_OK) {
+		// Not started when its bring-up failed
+		if (esp_eth_stop(bring_down.eth_handle) == ESP_OK &&
+			xSemaphoreTake(bring_down.stopped,
+						   pdMS_TO_TICKS(BRING_DOWN_STOP_TIMEOUT_MS)) !=
+				pdTRUE) {
+			LOGW("Interface %" PRIu32 " stop event not handled",
+				 interface->index);
+		}
+
+		esp_event_handler_instance_unregister(ETH_EVENT, ETHERNET_EVENT_STOP,
+											  instance);
+	}
+
+	vSemaphoreDelete(bring_down.stopped);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	if (interface->netif_glue != NULL) {
+		ethernet_driver_netif_glue_del(interface->netif_glue);
+		interface->netif_glue = NULL;
+	}
+
+	ret = esp_eth_driver_uninstall(bring_down.eth_handle);
+
+	if (ret == ESP_OK) {
+		interface->eth_handle = NULL;
+	}
+
+	return ret;
+}
+
+static void bring_up_task(void *arg) {
+	interface_t *interface = arg;
+
+	if (create_interface(interface) == ESP_OK) {
+		bring_up_interface(interface);
+	}
+
+	interface->bringing_up = false;
+
+	vTaskDelete(NULL);
+}
 
 #if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-	// Create new default instance of esp-netif for Ethernet
-	config->internal_config.eth_netif =
-		esp_netif_new(&config->internal_config.netif_config);
-
-	// Init MAC and PHY configs to default
-	config->internal_config.eth_phy_config.phy_addr =
-		CONFIG_ETHERNET_DRIVER_PHY_ADDR;
-	config->internal_config.eth_phy_config.reset_gpio_num =
-		CONFIG_ETHERNET_DRIVER_PHY_RST_GPIO;
-	config->internal_config.eth_mac_config.smi_mdc_gpio_num =
-		CONFIG_ETHERNET_DRIVER_MDC_GPIO;
-	config->internal_config.eth_mac_config.smi_mdio_gpio_num =
-		CONFIG_ETHERNET_DRIVER_MDIO_GPIO;
-
-	config->internal_config.eth_mac =
-		esp_eth_mac_new_esp32(&config->internal_config.eth_mac_config);
+typedef struct init_internal_mac_s {
+	eth_mac_config_t mac_config; // With the pins and RX task of the EMAC
+	esp_eth_mac_t   *eth_mac;
+} init_internal_mac_t;
+
+/** Run on the core the RX task of the EMAC is pinned to */
+static void init_internal_mac(void *arg) {
+	init_internal_mac_t *init = arg;
+
+	init->eth_mac = esp_eth_mac_new_esp32(&init->mac_config);
+}
+
+/** MAC and PHY of the internal EMAC, run by its bring-up */
+static esp_err_t create_internal(interface_t *interface) {
+	const ethernet_driver_internal_config_t *internal_config =
+		interface->create_arg;
+	init_internal_mac_t init;
+	eth_phy_config_t    phy_config = internal_config->eth_phy_config;
+
+	ethernet_driver_rx_task_mac_config(&internal_config->rx_task,
+									   &internal_config->eth_mac_config,
+									   &init.mac_config);
+
+	init.mac_config.smi_mdc_gpio_num  = internal_config->mdc_gpio;
+	init.mac_config.smi_mdio_gpio_num = internal_config->mdio_gpio;
+	init.eth_mac                      = NULL;
+
+	esp_err_t ret = ethernet_driver_rx_task_run(&internal_config->rx_task,
+												init_internal_mac, &init);
+
+	interface->eth_mac = init.eth_mac;
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	phy_config.phy_addr       = internal_config->phy_addr;
+	phy_config.reset_gpio_num = internal_config->phy_reset_gpio;
 
 	#if CONFIG_ETHERNET_DRIVER_PHY_IP101
-	config->internal_config.eth_phy =
-		esp_eth_phy_new_ip101(&config->internal_config.eth_phy_config);
+	interface->eth_phy = esp_eth_phy_new_ip101(&phy_config);
 	#elif CONFIG_ETHERNET_DRIVER_PHY_RTL8201
-	config->internal_config.eth_phy =
-		esp_eth_phy_new_rtl8201(&config->internal_config.eth_phy_config);
+	interface->eth_phy = esp_eth_phy_new_rtl8201(&phy_config);
 	#elif CONFIG_ETHERNET_DRIVER_PHY_LAN87XX
-	config->internal_config.eth_phy =
-		esp_eth_phy_new_lan87xx(&config->internal_config.eth_phy_config);
+	interface->eth_phy = esp_eth_phy_new_lan87xx(&phy_config);
 	#elif CONFIG_ETHERNET_DRIVER_PHY_DP83848
-	config->internal_config.eth_phy =
-		esp_eth_phy_new_dp83848(&config->internal_config.eth_phy_config);
-	#elif CONFIG_EXAMPLE_ETH_PHY_KSZ80XX
-	config->internal_config.eth_phy =
-		esp_eth_phy_new_ksz80xx(&config->internal_config.eth_phy_config);
+	interface->eth_phy = esp_eth_phy_new_dp83848(&phy_config);
+	#elif CONFIG_ETHERNET_DRIVER_PHY_KSZ8041 || \
+		CONFIG_ETHERNET_DRIVER_PHY_KSZ8081
+	interface->eth_phy = esp_eth_phy_new_ksz80xx(&phy_config);
+	#elif CONFIG_ETHERNET_DRIVER_PHY_AUTO
+	interface->eth_phy = ethernet_driver_phy_probe_new(&phy_config);
 	#endif
 
-	config->internal_config.eth_config = ETH_DEFAULT_CONFIG(
-		config->internal_config.eth_mac, config->internal_config.eth_phy);
+	#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+	if (interface->eth_mac != NULL) {
+		ret = ethernet_driver_mac_filter_attach(
+			ETHERNET_DRIVER_INTERNAL_INDEX, interface->eth_mac,
+			&ethernet_driver_mac_filter_esp32);
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
+
+	return ret;
+}
 
-	ESP_ERROR_CHECK(
-		esp_eth_driver_install(&config->internal_config.eth_config,
-							   &config->internal_config.eth_handle));
-	/* attach Ethernet driver to TCP/IP stack */
-	ESP_ERROR_CHECK(esp_netif_attach(
-		config->internal_config.eth_netif,
-		esp_eth_new_netif_glue(config->internal_config.eth_handle)));
+/** Netif of the internal EMAC, its MAC and PHY are left to the bring-up */
+static esp_err_t init_internal(
+	const ethernet_driver_internal_config_t *internal_config) {
+	esp_netif_t                       *netif;
+	ethernet_driver_internal_config_t *create_arg =
+		malloc(sizeof(ethernet_driver_internal_config_t));
+
+	if (create_arg == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	esp_err_t ret =
+		init_netif(internal_config->netif_base, NULL, NULL, 0, &netif);
+
+	if (ret != ESP_OK) {
+		free(create_arg);
+
+		return ret;
+	}
+
+	interface_t *interface =
+		init_interface(ETHERNET_DRIVER_INTERNAL_INDEX, netif, NULL);
+
+	*create_arg           = *internal_config;
+	interface->create     = create_internal;
+	interface->create_arg = create_arg;
+
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ret = init_frame_pool(&s_internal_frame_pool);
+
+	if (ret == ESP_OK) {
+		ret = ethernet_driver_netstack_set_frame_pool(netif,
+													  s_internal_frame_pool);
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	return ret;
+}
 #endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
 
 #if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
-	// Create instance(s) of esp-netif for SPI Ethernet(s)
-	config->spi_config.netif_config.base =
-		&config->spi_config.netif_inherent_config;
+/** SPI device settings the chip of a module expects */
+static void init_spi_device_interface_config(
+	const ethernet_driver_spi_module_config_t *module_config,
+	spi_device_interface_config_t             *device_interface_config) {
+	memset(device_interface_config, 0, sizeof(spi_device_interface_config_t));
+
+	switch (module_config->type) {
+		case ETHERNET_DRIVER_SPI_MODULE_DM9051:
+			device_interface_config->command_bits = 1;
+			device_interface_config->address_bits = 7;
+			break;
+		case ETHERNET_DRIVER_SPI_MODULE_W5500:
+			device_interface_config->command_bits = 16;
+			device_interface_config->address_bits = 8;
+			device_interface_config->flags        = SPI_DEVICE_NO_DUMMY;
+			break;
+		default:
+			break;
+	}
+
+	device_interface_config->mode           = 0;
+	device_interface_config->clock_speed_hz = module_config->clock_speed_hz;
+	device_interface_config->queue_size     = 20;
+	device_interface_config->spics_io_num   = module_config->spi_cs_gpio;
+}
+
+/**
+ * What the bring-up of one SPI module creates it from, copied out of the
+ * configuration by the init. The chip drivers copy it in turn.
+ */
+typedef struct init_spi_mac_s {
+	int                                 num;
+	ethernet_driver_spi_module_config_t module_config;
+	#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+	ethernet_driver_rx_poll_config_t rx_poll_config;
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+	eth_mac_config_t              mac_config; // With the module's RX task
+	eth_phy_config_t              phy_config;
+	spi_device_interface_config_t device_interface_config;
+	esp_eth_mac_t                *eth_mac;
+	esp_eth_phy_t                *eth_phy;
+	esp_err_t                     ret; // Of the hooks attached with the MAC
+} init_spi_mac_t;
+
+/**
+ * MAC and PHY of an SPI module, run on the core its RX task is pinned to.
+ * The RX poll task is created alongside.
+ */
+static void init_spi_module_mac(void *arg) {
+	init_spi_mac_t                            *init = arg;
+	int                                        num  = init->num;
+	const ethernet_driver_spi_module_config_t *module_config =
+		&init->module_config;
+	spi_device_interface_config_t *device_interface_config =
+		&init->device_interface_config;
+
+	switch (module_config->type) {
+	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+		case ETHERNET_DRIVER_SPI_MODULE_KSZ8851SNL: {
+			eth_ksz8851snl_config_t device_config =
+				ETH_KSZ8851SNL_DEFAULT_CONFIG(module_config->spi_host,
+											  device_interface_config);
+
+			device_config.int_gpio_num = module_config->int_gpio;
+
+			init->eth_mac = esp_eth_mac_new_ksz8851snl(&device_config,
+													   &init->mac_config);
+			init->eth_phy = esp_eth_phy_new_ksz8851snl(&init->phy_config);
+			break;
+		}
+	#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051
+		case ETHERNET_DRIVER_SPI_MODULE_DM9051: {
+			eth_dm9051_config_t device_config = ETH_DM9051_DEFAULT_CONFIG(
+				module_config->spi_host, device_interface_config);
+
+			device_config.int_gpio_num = module_config->int_gpio;
+
+			init->eth_mac =
+				esp_eth_mac_new_dm9051(&device_config, &init->mac_config);
+			init->eth_phy = esp_eth_phy_new_dm9051(&init->phy_config);
+			break;
+		}
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051
+	#if CONFIG_ETHERNET_DRIVER_USE_W5500
+		case ETHERNET_DRIVER_SPI_MODULE_W5500: {
+			eth_w5500_config_t device_config = ETH_W5500_DEFAULT_CONFIG(
+				module_config->spi_host, device_interface_config);
+
+			device_config.int_gpio_num = module_config->int_gpio;
+
+			init->eth_mac =
+				esp_eth_mac_new_w5500(&device_config, &init->mac_config);
+			init->eth_phy = esp_eth_phy_new_w5500(&init->phy_config);
+			break;
+		}
+	#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+		default:
+			// The bring-up of the module reports the missing MAC
+			LOGE("SPI module %d: chip type %d is not enabled", num,
+				 module_config->type);
+			break;
+	}
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+	// Polling is switched on and off with the interrupt line
+	if (init->eth_mac != NULL && module_config->int_gpio >= 0) {
+		// Only the DM9051 drives its interrupt line high
+		int int_active_level =
+			module_config->type == ETHERNET_DRIVER_SPI_MODULE_DM9051 ? 1 : 0;
+		// The other receives check the RX size of the chip themselves
+		ethernet_driver_rx_poll_pending_t pending = NULL;
+
+		#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+		if (module_config->type == ETHERNET_DRIVER_SPI_MODULE_KSZ8851SNL) {
+			pending = ethernet_driver_rx_poll_pending_ksz8851;
+		}
+		#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+
+		init->ret = ethernet_driver_rx_poll_attach(
+			num, init->eth_mac, module_config->int_gpio, int_active_level,
+			pending, &init->rx_poll_config, &init->mac_config);
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+
+	#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+	const ethernet_driver_mac_filter_chip_t *chip = NULL;
+
+	switch (module_config->type) {
+		#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+		case ETHERNET_DRIVER_SPI_MODULE_KSZ8851SNL:
+			chip = &ethernet_driver_mac_filter_ksz8851;
+			break;
+		#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+		#if CONFIG_ETHERNET_DRIVER_USE_DM9051
+		case ETHERNET_DRIVER_SPI_MODULE_DM9051:
+			chip = &ethernet_driver_mac_filter_dm9051;
+			break;
+		#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051
+		#if CONFIG_ETHERNET_DRIVER_USE_W5500
+		case ETHERNET_DRIVER_SPI_MODULE_W5500:
+			chip = &ethernet_driver_mac_filter_w5500;
+			break;
+		#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+		default:
+			break;
+	}
+
+	if (init->ret == ESP_OK && init->eth_mac != NULL && chip != NULL) {
+		init->ret = ethernet_driver_mac_filter_attach(
+			ETHERNET_DRIVER_SPI_INDEX(num), init->eth_mac, chip);
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
+}
+
+/**
+ * MAC and PHY of an SPI module, run by its bring-up. The clock is
+ * calibrated first, the transactions are counted from then on.
+ */
+static esp_err_t create_spi_module(interface_t *interface) {
+	init_spi_mac_t                            *init = interface->create_arg;
+	const ethernet_driver_spi_module_config_t *module_config =
+		&init->module_config;
+	spi_device_interface_config_t *device_interface_config =
+		&init->device_interface_config;
+
+	init_spi_device_interface_config(module_config, device_interface_config);
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION
+	int clock_speed_hz = module_config->clock_speed_hz;
+
+	// Keep the configured clock when calibration fails, the MAC reports it
+	if (ethernet_driver_spi_calibrate(init->num, module_config,
+									  device_interface_config,
+									  &clock_speed_hz) == ESP_OK) {
+		device_interface_config->clock_speed_hz = clock_speed_hz;
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION
+
+	// Count and time the SPI transactions of this module
+	esp_err_t ret =
+		ethernet_driver_stats_hook_spi(init->num, device_interface_config);
+
+	if (ret == ESP_OK) {
+		ret = ethernet_driver_rx_task_run(&module_config->rx_task,
+										  init_spi_module_mac, init);
+	}
+
+	interface->eth_mac = init->eth_mac;
+	interface->eth_phy = init->eth_phy;
+
+	return ret == ESP_OK ? init->ret : ret;
+}
+
+/** Copy what the bring-up of SPI module num needs from the configuration */
+static void init_spi_module(const ethernet_driver_spi_config_t *spi_config,
+							int num, init_spi_mac_t *init) {
+	const ethernet_driver_spi_module_config_t *module_config =
+		&spi_config->module_config[num];
+
+	init->num           = num;
+	init->module_config = *module_config;
+	init->phy_config    = spi_config->eth_phy_config;
+	init->ret           = ESP_OK;
 
-	char if_key_str[10];
-	char if_desc_str[10];
-	char num_str[3];
+	#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+	init->rx_poll_config = spi_config->rx_poll_config;
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
 
-	for (int i = 0; i < CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM; i++) {
-		itoa(i, num_str, 10);
-		strcat(strcpy(if_key_str, "ETH_SPI_"), num_str);
-		strcat(strcpy(if_desc_str, "eth"), num_str);
+	// Set remaining GPIO numbers and configuration used by the SPI module
+	init->phy_config.phy_addr       = module_config->phy_addr;
+	init->phy_config.reset_gpio_num = module_config->phy_reset_gpio;
 
-		config->spi_config.netif_inherent_config.if_key     = if_key_str;
-		config->spi_config.netif_inherent_config.if_desc    = if_desc_str;
-		config->spi_config.netif_inherent_config.route_prio = 30 - i;
+	ethernet_driver_rx_task_mac_config(&module_config->rx_task,
+									   &spi_config->eth_mac_config,
+									   &init->mac_config);
+}
+
+/**
+ * Netifs and buses of the SPI modules, their MACs and PHYs are left to the
+ * bring-up of each module
+ */
+static esp_err_t init_spi(const ethernet_driver_spi_config_t *spi_config) {
+	char      if_key_str[10];
+	char      if_desc_str[10];
+	int       module_num = spi_config->module_num;
+	int       bus_num    = spi_config->bus_num;
+	esp_err_t ret        = ESP_OK;
+
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ret = init_frame_pool(&s_spi_frame_pool);
 
-		config->spi_config.netif[i] =
-			esp_netif_new(&config->spi_config.netif_config);
+	if (ret != ESP_OK) {
+		return ret;
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	if (module_num > CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM) {
+		LOGE("%d SPI modules configured, using the first %d", module_num,
+			 CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM);
+
+		module_num = CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM;
+	}
+
+	if (bus_num > ETHERNET_DRIVER_SPI_BUSES_MAX) {
+		LOGE("%d SPI buses configured, using the first %d", bus_num,
+			 ETHERNET_DRIVER_SPI_BUSES_MAX);
+
+		bus_num = ETHERNET_DRIVER_SPI_BUSES_MAX;
 	}
 
 	// Install GPIO ISR handler to be able to service SPI Eth modlues interrupts
-	ESP_ERROR_CHECK(gpio_install_isr_service(0));
-
-	// Init SPI bus
-	ESP_ERROR_CHECK(spi_bus_initialize(CONFIG_ETHERNET_DRIVER_SPI_HOST,
-									   &config->spi_config.bus_config,
-									   SPI_DMA_CH_AUTO));
-
-	// Init specific SPI Ethernet module configuration from Kconfig (CS GPIO,
-	// Interrupt GPIO, etc.)
-	INIT_SPI_ETHERNET_MODULE_CONFIG(config->spi_config.module_config, 0);
-	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 1
-	INIT_SPI_ETHERNET_MODULE_CONFIG(config->spi_config.module_config, 1);
-	#endif
+	ret = gpio_install_isr_service(0);
 
-	// Configure SPI interface and Ethernet driver for specific SPI module
-	for (int i = 0; i < CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM; i++) {
-	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
-		// Set SPI module Chip Select GPIO
-		config->spi_config.device_interface_config.spics_io_num =
-			config->spi_config.module_config[i].spi_cs_gpio;
-
-		// ESP_ERROR_CHECK(
-		// 	spi_bus_add_device(CONFIG_ETHERNET_DRIVER_SPI_HOST,
-		// 					   &config->spi_config.device_interface_config,
-		// 					   &config->spi_config.device_handle[i]));
-		// KSZ8851SNL ethernet driver is based on spi driver
-		config->spi_config.device_config =
-			ETH_KSZ8851SNL_DEFAULT_CONFIG(&config->spi_config.device_interface_config);
-
-		// Set remaining GPIO numbers and configuration used by the SPI module
-		config->spi_config.device_config.int_gpio_num =
-			config->spi_config.module_config[i].int_gpio;
-		config->spi_config.eth_phy_config.phy_addr =
-			config->spi_config.module_config[i].phy_addr;
-		config->spi_config.eth_phy_config.reset_gpio_num =
-			config->spi_config.module_config[i].phy_reset_gpio;
-
-		config->spi_config.eth_mac[i] =
-			esp_eth_mac_new_ksz8851snl(&config->spi_config.device_config,
-									   &config->spi_config.eth_mac_config);
-		config->spi_config.eth_phy[i] =
-			esp_eth_phy_new_ksz8851snl(&config->spi_config.eth_phy_config);
-	#elif CONFIG_ETHERNET_DRIVER_USE_DM9051
-		// Set SPI module Chip Select GPIO
-		config->spi_config.device_interface_config.spics_io_num =
-			config->spi_config.module_config[i].spi_cs_gpio;
-
-		// ESP_ERROR_CHECK(
-		// 	spi_bus_add_device(CONFIG_ETHERNET_DRIVER_SPI_HOST,
-		// 					   &config->spi_config.device_interface_config,
-		// 					   &config->spi_config.device_handle[i]));
-		// dm9051 ethernet driver is based on spi driver
-		config->spi_config.device_config =
-			ETH_DM9051_DEFAULT_CONFIG(&config->spi_config.device_interface_config);
-
-		// Set remaining GPIO numbers and configuration used by the SPI module
-		config->spi_config.device_config.int_gpio_num =
-			config->spi_config.module_config[i].int_gpio;
-		config->spi_config.eth_phy_config.phy_addr =
-			config->spi_config.module_config[i].phy_addr;
-		config->spi_config.eth_phy_config.reset_gpio_num =
-			config->spi_config.module_config[i].phy_reset_gpio;
-
-		config->spi_config.eth_mac[i] =
-			esp_eth_mac_new_dm9051(&config->spi_config.device_config,
-								   &config->spi_config.eth_mac_config);
-		config->spi_config.eth_phy[i] =
-			esp_eth_phy_new_dm9051(&config->spi_config.eth_phy_config);
-	#elif CONFIG_ETHERNET_DRIVER_USE_W5500
-		// Set SPI module Chip Select GPIO
-		config->spi_config.device_interface_config.spics_io_num =
-			config->spi_config.module_config[i].spi_cs_gpio;
-
-		// ESP_ERROR_CHECK(
-		// 	spi_bus_add_device(CONFIG_ETHERNET_DRIVER_SPI_HOST,
-		// 					   &config->spi_config.device_interface_config,
-		// 					   &config->spi_config.device_interface_config));
-		// w5500 ethernet driver is based on spi driver
-		config->spi_config.device_config =
-			(eth_w5500_config_t)ETH_W5500_DEFAULT_CONFIG(CONFIG_ETHERNET_DRIVER_SPI_HOST,
-				&config->spi_config.device_interface_config);
-
-		// Set remaining GPIO numbers and configuration used by the SPI module
-		config->spi_config.device_config.int_gpio_num =
-			config->spi_config.module_config[i].int_gpio;
-		config->spi_config.eth_phy_config.phy_addr =
-			config->spi_config.module_config[i].phy_addr;
-		config->spi_config.eth_phy_config.reset_gpio_num =
-			config->spi_config.module_config[i].phy_reset_gpio;
-
-		config->spi_config.eth_mac[i] =
-			esp_eth_mac_new_w5500(&config->spi_config.device_config,
-								  &config->spi_config.eth_mac_config);
-		config->spi_config.eth_phy[i] =
-			esp_eth_phy_new_w5500(&config->spi_config.eth_phy_config);
-	#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+	if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+		return ret;
 	}
 
-	uint8_t mac_address[6] = {0};
-	ESP_ERROR_CHECK(esp_read_mac(mac_address, ESP_MAC_ETH));
+	s_isr_service_installed = ret == ESP_OK;
+
+	// Init SPI bus(es), modules on different hosts transfer in parallel
+	for (int i = 0; i < bus_num; i++) {
+		ret = spi_bus_initialize(spi_config->bus[i].host,
+								 &spi_config->bus[i].bus_config,
+								 SPI_DMA_CH_AUTO);
 
-	for (int i = 0; i < CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM; i++) {
-		config->spi_config.eth_config = (esp_eth_config_t)ETH_DEFAULT_CONFIG(
-			config->spi_config.eth_mac[i], config->spi_config.eth_phy[i]);
+		if (ret != ESP_OK) {
+			return ret;
+		}
+
+		s_spi_hosts[i] = spi_config->bus[i].host;
+		s_spi_bus_num  = i + 1;
+	}
 
-		ESP_ERROR_CHECK(esp_eth_driver_install(
-			&config->spi_config.eth_config, &config->spi_config.eth_handle[i]));
+	uint8_t eth_mac_address[6] = {0};
+	uint8_t base_mac_address[6] = {0};
+
+	ret = esp_read_mac(eth_mac_address, ESP_MAC_ETH);
+
+	if (ret == ESP_OK) {
+		// The internal EMAC uses ESP_MAC_ETH itself
+		ret = esp_derive_local_mac(base_mac_address, eth_mac_address);
+	}
+
+	// Create instance(s) of esp-netif for SPI Ethernet(s)
+	for (int i = 0; ret == ESP_OK && i < module_num; i++) {
+		esp_netif_t    *netif;
+		init_spi_mac_t *init = calloc(1, sizeof(init_spi_mac_t));
+
+		if (init == NULL) {
+			return ESP_ERR_NO_MEM;
+		}
+
+		snprintf(if_key_str, sizeof(if_key_str), "ETH_SPI_%d", i);
+		snprintf(if_desc_str, sizeof(if_desc_str), "eth%d", i);
+
+		ret = init_netif(spi_config->netif_base, if_key_str, if_desc_str,
+						 30 - i, &netif);
+
+		if (ret != ESP_OK) {
+			free(init);
+
+			return ret;
+		}
 
 		/* The SPI Ethernet module might not have a burned factory MAC address,
-	   we cat to set it manually. 02:00:00 is a Locally Administered OUI range
-	   so should not be used except when testing on a LAN under your control.
+		   so each gets the locally administered address derived from
+		   ESP_MAC_ETH plus its number, carried over the last three bytes.
 		*/
-		mac_address[5] = mac_address[5] + i;
+		uint8_t  mac_address[6];
+		uint32_t nic = ((uint32_t)base_mac_address[3] << 16 |
+						(uint32_t)base_mac_address[4] << 8 |
+						base_mac_address[5]) +
+					   i;
 
-		ESP_ERROR_CHECK(esp_eth_ioctl(config->spi_config.eth_handle[i],
-									  ETH_CMD_S_MAC_ADDR, mac_address));
+		memcpy(mac_address, base_mac_address, 3);
+		mac_address[3] = nic >> 16;
+		mac_address[4] = nic >> 8;
+		mac_address[5] = nic;
 
-		// attach Ethernet driver to TCP/IP stack
-		ESP_ERROR_CHECK(esp_netif_attach(
-			config->spi_config.netif[i],
-			esp_eth_new_netif_glue(config->spi_config.eth_handle[i])));
+		interface_t *interface =
+			init_interface(ETHERNET_DRIVER_SPI_INDEX(i), netif, mac_address);
+
+		init_spi_module(spi_config, i, init);
+
+		interface->create     = create_spi_module;
+		interface->create_arg = init;
+
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+		ret = ethernet_driver_netstack_set_frame_pool(netif, s_spi_frame_pool);
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
 	}
-#endif // CONFIG_ETH_USE_SPI_ETHERNET
 
-	// Register user defined event handers
-	ESP_ERROR_CHECK(esp_event_handler_register(ETH_EVENT, ESP_EVENT_ANY_ID,
-											   &eth_event_handler, NULL));
-	ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_ETH_GOT_IP,
-											   &got_ip_event_handler, NULL));
+	return ret;
+}
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+/**
+ * Netifs, MACs and PHYs of the virtual interfaces. They are only memory,
+ * so they are created right away and joined.
+ */
+static esp_err_t init_virtual(
+	const ethernet_driver_virtual_config_t *virtual_config) {
+	ethernet_driver_loopback_config_t loopback_config =
+		virtual_config->loopback_config;
+	interface_t *interface[CONFIG_ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM];
+	char         if_key_str[12];
+	char         if_desc_str[12];
+	esp_err_t    ret = ESP_OK;
+
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ret = init_frame_pool(&s_virtual_frame_pool);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	loopback_config.frame_pool = s_virtual_frame_pool;
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	// Locally administered addresses, there is no factory MAC to derive from
+	uint8_t mac_address[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+	// Create instance(s) of esp-netif for virtual Ethernet(s)
+	for (int i = 0; i < CONFIG_ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM; i++) {
+		esp_netif_t *netif;
+
+		snprintf(if_key_str, sizeof(if_key_str), "ETH_VIRT_%d", i);
+		snprintf(if_desc_str, sizeof(if_desc_str), "veth%d", i);
+
+		ret = init_netif(virtual_config->netif_base, if_key_str, if_desc_str,
+						 20 - i, &netif);
+
+		if (ret != ESP_OK) {
+			return ret;
+		}
+
+		mac_address[5] = i + 1;
+		interface[i] = init_interface(ETHERNET_DRIVER_VIRTUAL_INDEX(i), netif,
+									  mac_address);
+
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+		ret = ethernet_driver_netstack_set_frame_pool(netif,
+													  s_virtual_frame_pool);
+
+		if (ret != ESP_OK) {
+			return ret;
+		}
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+		interface[i]->eth_mac = ethernet_driver_loopback_mac_new(
+			&loopback_config, &virtual_config->eth_mac_config);
+		interface[i]->eth_phy =
+			ethernet_driver_loopback_phy_new(&virtual_config->eth_phy_config);
+
+		if (interface[i]->eth_mac == NULL || interface[i]->eth_phy == NULL) {
+			return ESP_ERR_NO_MEM;
+		}
+	}
+
+	#if CONFIG_ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM > 1
+	// Two virtual modules behave like a pair of ports joined by a cable
+	ret = ethernet_driver_loopback_connect(interface[0]->eth_mac,
+										   interface[1]->eth_mac);
+	#endif
+
+	return ret;
+}
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+/** Release what init_interfaces() created once every interface is down */
+static void deinit_interfaces(void) {
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		interface_t *interface = &s_interfaces[i];
+
+		if (!interface->used) {
+			continue;
+		}
+
+#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+		ethernet_driver_mac_filter_detach(interface->index);
+#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
+
+		// The hooks of the other modules are released by the del methods
+		if (interface->eth_mac != NULL) {
+			interface->eth_mac->del(interface->eth_mac);
+		}
+
+		if (interface->eth_phy != NULL) {
+			interface->eth_phy->del(interface->eth_phy);
+		}
+
+		// Left by a bring-up that never ran
+		free(interface->create_arg);
+
+		ethernet_driver_netstack_unbind(interface->netif);
+		esp_netif_destroy(interface->netif);
+	}
+
+	memset(s_interfaces, 0, sizeof(s_interfaces));
+
+#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && \
+	CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ethernet_driver_frame_pool_del(s_internal_frame_pool);
+	s_internal_frame_pool = NULL;
+#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && FRAME_POOL
+
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+	// The SPI devices were removed with their MAC
+	for (int i = 0; i < s_spi_bus_num; i++) {
+		if (spi_bus_free(s_spi_hosts[i]) != ESP_OK) {
+			LOGW("Could not free SPI host %d", s_spi_hosts[i]);
+		}
+	}
+
+	s_spi_bus_num = 0;
+
+	if (s_isr_service_installed) {
+		gpio_uninstall_isr_service();
+
+		s_isr_service_installed = false;
+	}
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ethernet_driver_frame_pool_del(s_spi_frame_pool);
+	s_spi_frame_pool = NULL;
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET && \
+	CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ethernet_driver_frame_pool_del(s_virtual_frame_pool);
+	s_virtual_frame_pool = NULL;
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET && FRAME_POOL
+}
+
+/**
+ * Create the netifs of every interface for the bring-up, the MACs and PHYs
+ * of the virtual ones. What was created is released again on failure.
+ */
+static esp_err_t init_interfaces(const ethernet_driver_config_t *config) {
+	if (config == NULL) {
+		config = &s_default_config;
+	}
+
+	// Initialize TCP/IP network interface (should be called only once in
+	// application)
+	esp_err_t ret = esp_netif_init();
+
+#if CONFIG_ETHERNET_DRIVER_TRACE
+	if (ret == ESP_OK) {
+		ret = ethernet_driver_trace_init();
+	}
+#endif // CONFIG_ETHERNET_DRIVER_TRACE
+	// Create default event loop that running in background
+	// ESP_ERROR_CHECK(esp_event_loop_create_default());
 
-	/* start Ethernet driver state machine */
 #if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-	ESP_ERROR_CHECK(esp_eth_start(config->internal_config.eth_handle));
+	if (ret == ESP_OK) {
+		ret = init_internal(&config->internal_config);
+	}
 #endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-
 #if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
-	for (int i = 0; i < CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM; i++) {
-		ESP_ERROR_CHECK(esp_eth_start(config->spi_config.eth_handle[i]));
+	if (ret == ESP_OK) {
+		ret = init_spi(&config->spi_config);
+	}
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	if (ret == ESP_OK) {
+		ret = init_virtual(&config->virtual_config);
+	}
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+	// Register user defined event handers
+	if (ret == ESP_OK) {
+		ret = esp_event_handler_register(ETH_EVENT, ESP_EVENT_ANY_ID,
+										 &eth_event_handler, NULL);
+	}
+
+	if (ret == ESP_OK) {
+		ret = esp_event_handler_register(IP_EVENT, IP_EVENT_ETH_GOT_IP,
+										 &got_ip_event_handler, NULL);
+
+		if (ret != ESP_OK) {
+			esp_event_handler_unregister(ETH_EVENT, ESP_EVENT_ANY_ID,
+										 &eth_event_handler);
+		}
+	}
+
+	if (ret != ESP_OK) {
+		LOGE("Init failed: %s", esp_err_to_name(ret));
+		deinit_interfaces();
+
+		return ret;
+	}
+
+	s_initialized = true;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_init(const ethernet_driver_config_t *config) {
+	if (s_initialized) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	ESP_ERROR_CHECK(ethernet_driver_boot_start(NULL, NULL));
+	ESP_ERROR_CHECK(init_interfaces(config));
+
+	/* start Ethernet driver state machine */
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_interfaces[i].used) {
+			ESP_ERROR_CHECK(create_interface(&s_interfaces[i]));
+			ESP_ERROR_CHECK(bring_up_interface(&s_interfaces[i]));
+		}
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_init_async(const ethernet_driver_config_t *config,
+									 ethernet_driver_ready_cb_t      ready_cb,
+									 void                           *arg) {
+	if (s_initialized) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	esp_err_t ret = ethernet_driver_boot_start(ready_cb, arg);
+
+	if (ret == ESP_OK) {
+		ret = init_interfaces(config);
+	}
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	// Chip init, PHY resets and auto-negotiation of every interface overlap
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		// Slots of SPI modules beyond module_num stay empty
+		if (!s_interfaces[i].used) {
+			continue;
+		}
+
+		s_interfaces[i].bringing_up = true;
+
+		if (xTaskCreate(bring_up_task, "eth_bring_up",
+						CONFIG_ETHERNET_DRIVER_BRING_UP_TASK_STACK_SIZE,
+						&s_interfaces[i],
+						CONFIG_ETHERNET_DRIVER_BRING_UP_TASK_PRIO,
+						NULL) != pdPASS) {
+			LOGE("Could not create bring-up task of interface %d", i);
+			ethernet_driver_boot_failed(i, ESP_ERR_NO_MEM);
+
+			s_interfaces[i].bringing_up = false;
+
+			ret = ESP_ERR_NO_MEM;
+		}
+	}
+
+	return ret;
+}
+
+esp_err_t ethernet_driver_deinit(void) {
+	if (!s_initialized) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_interfaces[i].bringing_up) {
+			LOGE("Interface %d is still being brought up", i);
+
+			return ESP_ERR_INVALID_STATE;
+		}
+	}
+
+	/* Interfaces already down stay down, so a failed deinit can be called
+	   again with the driver still initialized */
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (!s_interfaces[i].used || s_interfaces[i].eth_handle == NULL) {
+			continue;
+		}
+
+		esp_err_t ret = bring_down_interface(&s_interfaces[i]);
+
+		if (ret != ESP_OK) {
+			LOGE("Could not stop interface %d: %s", i, esp_err_to_name(ret));
+
+			return ret;
+		}
 	}
+
+	// Only now, the STOP events of the bring-down went through them
+	esp_event_handler_unregister(ETH_EVENT, ESP_EVENT_ANY_ID,
+								 &eth_event_handler);
+	esp_event_handler_unregister(IP_EVENT, IP_EVENT_ETH_GOT_IP,
+								 &got_ip_event_handler);
+
+	deinit_interfaces();
+
+	s_initialized = false;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_restart(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	interface_t *interface = &s_interfaces[index];
+
+	// Slots of SPI modules beyond module_num stay empty
+	if (!interface->used || interface->bringing_up) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	int64_t   start = esp_timer_get_time();
+	esp_err_t ret   = ESP_OK;
+
+	// Nothing to stop when the last bring-up failed to install the driver
+	if (interface->eth_handle != NULL) {
+		ret = bring_down_interface(interface);
+	}
+
+	if (ret != ESP_OK) {
+		LOGE("Could not stop interface %" PRIu32 ": %s", index,
+			 esp_err_to_name(ret));
+
+		return ret;
+	}
+
+	// Installing resets the PHY and the chip
+	ret = bring_up_interface(interface);
+
+	if (ret == ESP_OK) {
+		LOGI("Interface %" PRIu32 " restarted in %" PRIi64 " us", index,
+			 esp_timer_get_time() - start);
+	}
+
+	return ret;
+}
+
+esp_err_t ethernet_driver_get_handles(uint32_t                   index,
+									  ethernet_driver_handles_t *handles) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || handles == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	const interface_t *interface = &s_interfaces[index];
+
+	if (!interface->used) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	handles->netif      = interface->netif;
+	handles->eth_mac    = interface->eth_mac;
+	handles->eth_phy    = interface->eth_phy;
+	handles->eth_handle = interface->eth_handle;
+
+	return ESP_OK;
+}
+
+void ethernet_driver_get_ram_usage(ethernet_driver_ram_usage_t *usage) {
+	usage->interfaces      = ETHERNET_DRIVER_ETHERNETS_NUM;
+	usage->interface_bytes = sizeof(interface_t);
+	usage->static_bytes    = sizeof(s_interfaces) + sizeof(s_initialized);
+	usage->config_bytes    = sizeof(ethernet_driver_config_t);
+
+#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && \
+	CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	usage->static_bytes += sizeof(s_internal_frame_pool);
+#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && FRAME_POOL
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+	usage->static_bytes += sizeof(s_spi_hosts) + sizeof(s_spi_bus_num) +
+						   sizeof(s_isr_service_installed);
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	usage->static_bytes += sizeof(s_spi_frame_pool);
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
 #endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET && \
+	CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	usage->static_bytes += sizeof(s_virtual_frame_pool);
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET && FRAME_POOL
+}
+
+void ethernet_driver_print_ram_usage(void) {
+	ethernet_driver_ram_usage_t usage;
+
+	ethernet_driver_get_ram_usage(&usage);
+
+	LOGI("%10s %10s %10s %10s", "interfaces", "per iface", "static",
+		 "config");
+	LOGI("%10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32,
+		 usage.interfaces, usage.interface_bytes, usage.static_bytes,
+		 usage.config_bytes);
 }
@@ -0,0 +1,281 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_balance.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_BALANCE
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/event_groups.h"
+	#include "freertos/task.h"
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+
+	#include "lwip/tcpip.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_balance.h"
+
+LOG_TAG("ethernet_driver_balance");
+
+	#define BALANCE_ETH_HEADER_LEN  14
+	#define BALANCE_ETH_TYPE_IPV4   0x0800
+	#define BALANCE_IPV4_HEADER_MIN 20
+	#define BALANCE_IPV4_PROTO_TCP  6
+	#define BALANCE_IPV4_PROTO_UDP  17
+	#define BALANCE_IPV4_FRAG_MASK  0x3FFF
+
+typedef struct balance_remove_s {
+	ethernet_driver_netif_glue_handle_t glue;
+	TaskHandle_t                        caller;
+} balance_remove_t;
+
+typedef struct balance_member_s {
+	ethernet_driver_netif_glue_handle_t glue;
+	uint32_t                            ip;
+	uint32_t                            netmask;
+	uint8_t                             mac_address[6];
+	_Atomic uint32_t                    tx_frames;
+	_Atomic uint32_t                    tx_bytes;
+} balance_member_t;
+
+static balance_member_t s_members[ETHERNET_DRIVER_BALANCE_MEMBERS_NUM];
+static _Atomic uint32_t s_member_mask;
+static _Atomic uint32_t s_up_mask;
+static _Atomic uint32_t s_moved_frames;
+static _Atomic uint32_t s_unhashed;
+static _Atomic uint32_t s_rebalances;
+
+static uint32_t balance_read32(const uint8_t *data) {
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+		   ((uint32_t)data[2] << 8) | data[3];
+}
+
+/**
+ * Flow hash of an IPv4 frame. Ports are only used when the datagram is not
+ * fragmented, so every fragment of a datagram takes the same link.
+ */
+static bool balance_hash(const uint8_t *frame, size_t length,
+						 uint32_t *hash) {
+	if (length < BALANCE_ETH_HEADER_LEN + BALANCE_IPV4_HEADER_MIN ||
+		((frame[12] << 8) | frame[13]) != BALANCE_ETH_TYPE_IPV4) {
+		return false;
+	}
+
+	const uint8_t *ip       = frame + BALANCE_ETH_HEADER_LEN;
+	size_t         ip_len   = (ip[0] & 0x0F) * 4;
+	uint8_t        proto    = ip[9];
+	uint32_t       fragment = ((ip[6] << 8) | ip[7]) & BALANCE_IPV4_FRAG_MASK;
+	uint32_t       flow_hash =
+		balance_read32(ip + 12) ^ balance_read32(ip + 16) ^ proto;
+
+	if ((proto == BALANCE_IPV4_PROTO_TCP || proto == BALANCE_IPV4_PROTO_UDP) &&
+		fragment == 0 && length >= BALANCE_ETH_HEADER_LEN + ip_len + 4) {
+		flow_hash ^= balance_read32(ip + ip_len);
+	}
+
+	// Finalizer of murmur3, neighbouring ports end up on different links
+	flow_hash ^= flow_hash >> 16;
+	flow_hash *= 0x85EBCA6B;
+	flow_hash ^= flow_hash >> 13;
+	flow_hash *= 0xC2B2AE35;
+	flow_hash ^= flow_hash >> 16;
+
+	*hash = flow_hash;
+
+	return true;
+}
+
+esp_err_t ethernet_driver_balance_get_stats(
+	ethernet_driver_balance_stats_t *stats) {
+	if (stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	stats->up_mask = RELAXED_LOAD(s_up_mask);
+
+	for (int i = 0; i < ETHERNET_DRIVER_BALANCE_MEMBERS_NUM; i++) {
+		stats->tx_frames[i] = RELAXED_LOAD(s_members[i].tx_frames);
+		stats->tx_bytes[i]  = RELAXED_LOAD(s_members[i].tx_bytes);
+	}
+
+	stats->moved_frames = RELAXED_LOAD(s_moved_frames);
+	stats->unhashed     = RELAXED_LOAD(s_unhashed);
+	stats->rebalances   = RELAXED_LOAD(s_rebalances);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_balance_reset_stats(void) {
+	for (int i = 0; i < ETHERNET_DRIVER_BALANCE_MEMBERS_NUM; i++) {
+		RELAXED_CLEAR(s_members[i].tx_frames);
+		RELAXED_CLEAR(s_members[i].tx_bytes);
+	}
+
+	RELAXED_CLEAR(s_moved_frames);
+	RELAXED_CLEAR(s_unhashed);
+	RELAXED_CLEAR(s_rebalances);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_balance_add(ethernet_driver_netif_glue_handle_t glue,
+									  const esp_netif_ip_info_t *ip_info) {
+	if (glue == NULL || ip_info == NULL ||
+		glue->index >= ETHERNET_DRIVER_BALANCE_MEMBERS_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	uint32_t other_mask = RELAXED_LOAD(s_member_mask) & ~(1U << glue->index);
+
+	/*
+	 * A moved frame keeps the source IP and next hop MAC of the netif it
+	 * was routed to, only its source MAC changes. So every member must
+	 * reach the same hosts, which the same subnet stands in for.
+	 */
+	for (int i = 0; i < ETHERNET_DRIVER_BALANCE_MEMBERS_NUM; i++) {
+		if ((other_mask & (1U << i)) != 0 &&
+			(s_members[i].netmask != ip_info->netmask.addr ||
+			 ((s_members[i].ip ^ ip_info->ip.addr) & s_members[i].netmask) !=
+				 0)) {
+			return ESP_ERR_INVALID_STATE;
+		}
+	}
+
+	balance_member_t *member = &s_members[glue->index];
+
+	// The MAC address is set before the glue is created
+	esp_eth_ioctl(glue->eth_handle, ETH_CMD_G_MAC_ADDR, member->mac_address);
+	member->ip      = ip_info->ip.addr;
+	member->netmask = ip_info->netmask.addr;
+	member->glue    = glue;
+
+	atomic_fetch_or(&s_member_mask, 1U << glue->index);
+
+	return ESP_OK;
+}
+
+// In the tcpip thread, where every frame is balanced
+static void balance_remove(void *arg) {
+	balance_remove_t *remove = arg;
+	uint32_t          index  = remove->glue->index;
+
+	atomic_fetch_and(&s_member_mask, ~(1U << index));
+	s_members[index].glue = NULL;
+
+	xTaskNotifyGive(remove->caller);
+}
+
+void ethernet_driver_balance_remove(ethernet_driver_netif_glue_handle_t glue) {
+	if (glue == NULL || glue->index >= ETHERNET_DRIVER_BALANCE_MEMBERS_NUM) {
+		return;
+	}
+
+	balance_remove_t remove = {
+		.glue   = glue,
+		.caller = xTaskGetCurrentTaskHandle(),
+	};
+
+	/*
+	 * A frame of another member may have picked this glue already. Once
+	 * the tcpip thread ran the removal, no send on it is left and the glue
+	 * can be freed.
+	 */
+	if (tcpip_callback(balance_remove, &remove) == ERR_OK) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		return;
+	}
+
+	LOGE("Could not remove member %" PRIu32 " in the tcpip thread",
+		 glue->index);
+
+	atomic_fetch_and(&s_member_mask, ~(1U << glue->index));
+	s_members[glue->index].glue = NULL;
+}
+
+ethernet_driver_netif_glue_handle_t ethernet_driver_balance_select(
+	ethernet_driver_netif_glue_handle_t glue, uint8_t *frame, size_t length) {
+	uint32_t member_mask = RELAXED_LOAD(s_member_mask);
+
+	if (glue->index >= ETHERNET_DRIVER_BALANCE_MEMBERS_NUM ||
+		(member_mask & (1U << glue->index)) == 0) {
+		return glue;
+	}
+
+	// LINK_UP_BIT(index) is bit index of the boot event group
+	uint32_t up_mask =
+		xEventGroupGetBits(ethernet_driver_get_event_group()) & member_mask;
+
+	if (RELAXED_EXCHANGE(s_up_mask, up_mask) != up_mask) {
+		RELAXED_ADD(s_rebalances, 1);
+	}
+
+	int      up_num = __builtin_popcount(up_mask);
+	uint32_t hash   = 0;
+
+	if (up_num < 2) {
+		return glue;
+	}
+
+	if (!balance_hash(frame, length, &hash)) {
+		// ARP and the like stay on their link, peers learn its MAC from them
+		RELAXED_ADD(s_unhashed, 1);
+
+		return glue;
+	}
+
+	// The (hash % up_num)-th member whose link is up
+	for (int skip = hash % up_num; skip > 0; skip--) {
+		up_mask &= up_mask - 1;
+	}
+
+	balance_member_t *member = &s_members[__builtin_ctz(up_mask)];
+	ethernet_driver_netif_glue_handle_t target = member->glue;
+
+	if (target == NULL) {
+		return glue;
+	}
+
+	if (target != glue) {
+		// Source MAC of the link the frame leaves on, as switches learn it
+		memcpy(frame + 6, member->mac_address, 6);
+		RELAXED_ADD(s_moved_frames, 1);
+	}
+
+	RELAXED_ADD(member->tx_frames, 1);
+	RELAXED_ADD(member->tx_bytes, length);
+
+	return target;
+}
+#endif // CONFIG_ETHERNET_DRIVER_BALANCE
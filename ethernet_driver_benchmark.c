@@ -0,0 +1,838 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_benchmark.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_BENCHMARK ||              \
+	CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_BENCHMARK || \
+	CONFIG_ETHERNET_DRIVER_RESTART_BENCHMARK ||     \
+	CONFIG_ETHERNET_DRIVER_RX_FILTER_BENCHMARK ||   \
+	CONFIG_ETHERNET_DRIVER_TX_SCHED_BENCHMARK ||    \
+	CONFIG_ETHERNET_DRIVER_CHKSUM_BENCHMARK
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/task.h"
+
+	#include "esp_eth.h"
+	#include "esp_err.h"
+	#include "esp_timer.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_benchmark.h"
+
+LOG_TAG("ethernet_driver_benchmark");
+#endif // CONFIG_ETHERNET_DRIVER_*BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_BENCHMARK
+	#include "ethernet_driver_loopback.h"
+
+// IEEE 802 local experimental EtherType, dropped by lwIP right after parsing
+	#define BENCHMARK_ETHERTYPE 0x88B5
+
+static int benchmark_compare_u32(const void *a, const void *b) {
+	uint32_t va = *(const uint32_t *)a;
+	uint32_t vb = *(const uint32_t *)b;
+
+	return (va > vb) - (va < vb);
+}
+
+static esp_err_t benchmark_run_frame_size(
+	esp_eth_handle_t tx_handle, esp_eth_handle_t rx_handle,
+	esp_eth_mac_t *rx_mac, esp_netif_t *rx_netif, uint8_t *frame,
+	uint32_t *samples,
+	const ethernet_driver_benchmark_config_t *benchmark_config,
+	ethernet_driver_benchmark_result_t       *result) {
+	ethernet_driver_loopback_probe_t probe = {
+		.latency_us = samples,
+		.capacity   = benchmark_config->frames,
+	};
+	uint32_t size    = result->frame_size;
+	int64_t  timeout = (int64_t)benchmark_config->timeout_ms * 1000;
+
+	memset(frame, 0, size);
+	ESP_ERROR_CHECK(esp_eth_ioctl(rx_handle, ETH_CMD_G_MAC_ADDR, frame));
+	ESP_ERROR_CHECK(esp_eth_ioctl(tx_handle, ETH_CMD_G_MAC_ADDR, frame + 6));
+	frame[12] = BENCHMARK_ETHERTYPE >> 8;
+	frame[13] = BENCHMARK_ETHERTYPE & 0xFF;
+
+	ESP_ERROR_CHECK(ethernet_driver_loopback_set_probe(rx_mac, &probe));
+	ESP_ERROR_CHECK(ethernet_driver_netstack_reset_stats(rx_netif));
+
+	int64_t start = esp_timer_get_time();
+
+	while (result->frames_sent < benchmark_config->frames &&
+		   esp_timer_get_time() - start < timeout) {
+		if (esp_eth_transmit(tx_handle, frame, size) == ESP_OK) {
+			result->frames_sent++;
+		} else {
+			// Peer RX queue is full, let the receiver drain it
+			result->tx_retries++;
+			vTaskDelay(1);
+		}
+	}
+
+	while (probe.count < result->frames_sent &&
+		   esp_timer_get_time() - start < timeout) {
+		vTaskDelay(1);
+	}
+
+	ESP_ERROR_CHECK(ethernet_driver_loopback_set_probe(rx_mac, NULL));
+	// Give the RX task the chance to leave the probe before it goes away
+	vTaskDelay(1);
+
+	result->frames_received = probe.count;
+
+	if (probe.count == 0) {
+		LOGE("No frame of %" PRIu32 " bytes received", size);
+
+		return ESP_ERR_TIMEOUT;
+	}
+
+	result->duration_us = probe.last_rx_us - start;
+
+	if (result->duration_us > 0) {
+		result->frames_per_sec =
+			(uint64_t)probe.count * 1000000 / result->duration_us;
+		result->bytes_per_sec =
+			(uint64_t)probe.count * size * 1000000 / result->duration_us;
+	}
+
+	result->heap_allocations_per_10k =
+		(uint64_t)probe.heap_allocations * 10000 / result->frames_sent;
+
+	ethernet_driver_netstack_stats_t netstack_stats;
+
+	ESP_ERROR_CHECK(
+		ethernet_driver_netstack_get_stats(rx_netif, &netstack_stats));
+
+	if (netstack_stats.rx_frames > 0) {
+		result->rx_copied_bytes_per_frame =
+			netstack_stats.rx_copied_bytes / netstack_stats.rx_frames;
+	}
+
+	qsort(samples, probe.count, sizeof(uint32_t), benchmark_compare_u32);
+
+	result->latency_p50_us = samples[(probe.count * 50) / 100];
+	result->latency_p99_us = samples[(probe.count * 99) / 100];
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_benchmark_run(
+	const ethernet_driver_benchmark_config_t *benchmark_config,
+	ethernet_driver_benchmark_result_t       *results) {
+	if (benchmark_config == NULL || results == NULL ||
+		benchmark_config->frames == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	int rx_index = CONFIG_ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM - 1;
+
+	ethernet_driver_handles_t tx;
+	ethernet_driver_handles_t rx;
+
+	if (ethernet_driver_get_handles(ETHERNET_DRIVER_VIRTUAL_INDEX(0), &tx) !=
+			ESP_OK ||
+		ethernet_driver_get_handles(ETHERNET_DRIVER_VIRTUAL_INDEX(rx_index),
+									&rx) != ESP_OK) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	esp_eth_handle_t tx_handle = tx.eth_handle;
+	esp_eth_handle_t rx_handle = rx.eth_handle;
+	esp_eth_mac_t   *rx_mac    = rx.eth_mac;
+	esp_netif_t     *rx_netif  = rx.netif;
+
+	uint8_t  *frame   = malloc(ETH_MAX_PACKET_SIZE);
+	uint32_t *samples = malloc(benchmark_config->frames * sizeof(uint32_t));
+
+	if (frame == NULL || samples == NULL) {
+		LOGE("No memory for benchmark buffers");
+		free(frame);
+		free(samples);
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; i < ETHERNET_DRIVER_BENCHMARK_FRAME_SIZES_NUM; i++) {
+		memset(&results[i], 0, sizeof(ethernet_driver_benchmark_result_t));
+
+		results[i].frame_size = benchmark_config->frame_size[i];
+
+		if (results[i].frame_size < ETH_HEADER_LEN ||
+			results[i].frame_size > ETH_MAX_PACKET_SIZE) {
+			ret = ESP_ERR_INVALID_SIZE;
+			break;
+		}
+
+		ret = benchmark_run_frame_size(tx_handle, rx_handle, rx_mac, rx_netif,
+									   frame, samples, benchmark_config,
+									   &results[i]);
+
+		if (ret != ESP_OK) {
+			break;
+		}
+	}
+
+	free(samples);
+	free(frame);
+
+	return ret;
+}
+
+void ethernet_driver_benchmark_print(
+	const ethernet_driver_benchmark_result_t *results, size_t count) {
+	LOGI("%6s %9s %9s %11s %9s %9s %8s %10s %10s", "size", "sent",
+		 "frames/s", "bytes/s", "p50(us)", "p99(us)", "retries", "allocs/10k",
+		 "copy/frame");
+
+	for (size_t i = 0; i < count; i++) {
+		LOGI("%6" PRIu32 " %9" PRIu32 " %9" PRIu32 " %11" PRIu32 " %9" PRIu32
+			 " %9" PRIu32 " %8" PRIu32 " %10" PRIu32 " %10" PRIu32,
+			 results[i].frame_size, results[i].frames_sent,
+			 results[i].frames_per_sec, results[i].bytes_per_sec,
+			 results[i].latency_p50_us, results[i].latency_p99_us,
+			 results[i].tx_retries, results[i].heap_allocations_per_10k,
+			 results[i].rx_copied_bytes_per_frame);
+	}
+}
+#endif // CONFIG_ETHERNET_DRIVER_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_BENCHMARK
+/**
+ * Run time of the idle tasks summed and total run time, in ticks of the run
+ * time stats clock
+ */
+static esp_err_t benchmark_cpu_sample(uint32_t *idle, uint32_t *total) {
+	UBaseType_t   count  = uxTaskGetNumberOfTasks() + 4;
+	TaskStatus_t *status = malloc(count * sizeof(TaskStatus_t));
+
+	if (status == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	count = uxTaskGetSystemState(status, count, total);
+	*idle = 0;
+
+	for (UBaseType_t i = 0; i < count; i++) {
+		// One idle task per core, IDLE or IDLE<core> depending on the IDF
+		if (strncmp(status[i].pcTaskName, "IDLE", 4) == 0) {
+			*idle += status[i].ulRunTimeCounter;
+		}
+	}
+
+	free(status);
+
+	return ESP_OK;
+}
+
+static esp_err_t benchmark_rx_poll_mode(
+	uint32_t index, uint32_t duration_ms,
+	ethernet_driver_benchmark_rx_poll_result_t *result) {
+	ethernet_driver_stats_t         stats_start;
+	ethernet_driver_stats_t         stats_end;
+	ethernet_driver_rx_poll_stats_t rx_poll_stats;
+	uint32_t                        idle_start;
+	uint32_t                        idle_end;
+	uint32_t                        total_start;
+	uint32_t                        total_end;
+
+	ESP_ERROR_CHECK(ethernet_driver_rx_poll_set_mode(index, result->mode));
+	// Let the module settle into the mode before measuring
+	vTaskDelay(pdMS_TO_TICKS(100));
+	ESP_ERROR_CHECK(ethernet_driver_rx_poll_reset_stats(index));
+	ESP_ERROR_CHECK(ethernet_driver_get_stats(index, &stats_start));
+	ESP_ERROR_CHECK(benchmark_cpu_sample(&idle_start, &total_start));
+
+	int64_t start = esp_timer_get_time();
+
+	vTaskDelay(pdMS_TO_TICKS(duration_ms));
+
+	ESP_ERROR_CHECK(benchmark_cpu_sample(&idle_end, &total_end));
+	ESP_ERROR_CHECK(ethernet_driver_get_stats(index, &stats_end));
+	ESP_ERROR_CHECK(ethernet_driver_rx_poll_get_stats(index, &rx_poll_stats));
+
+	int64_t  duration_us = esp_timer_get_time() - start;
+	uint32_t frames      = stats_end.rx_frames - stats_start.rx_frames;
+	uint32_t total       = (total_end - total_start) * portNUM_PROCESSORS;
+	uint32_t idle        = idle_end - idle_start;
+
+	if (frames == 0) {
+		LOGE("No frame received on interface %" PRIu32, index);
+
+		return ESP_ERR_TIMEOUT;
+	}
+
+	result->frames_per_sec = (uint64_t)frames * 1000000 / duration_us;
+	result->bytes_per_sec  = (uint64_t)(stats_end.rx_bytes -
+										stats_start.rx_bytes) *
+							1000000 / duration_us;
+	result->rx_dropped     = stats_end.rx_dropped - stats_start.rx_dropped;
+	result->polled_frames  = rx_poll_stats.polled_frames;
+	result->irq_to_poll    = rx_poll_stats.irq_to_poll;
+
+	if (total > 0 && idle <= total) {
+		result->cpu_load_percent = 100 - (uint64_t)idle * 100 / total;
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_benchmark_rx_poll_run(
+	uint32_t index, uint32_t duration_ms,
+	ethernet_driver_benchmark_rx_poll_result_t *results) {
+	if (results == NULL || duration_ms == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	ethernet_driver_rx_poll_stats_t rx_poll_stats;
+
+	if (ethernet_driver_rx_poll_get_stats(index, &rx_poll_stats) != ESP_OK) {
+		LOGE("Interface %" PRIu32 " is not an SPI module", index);
+
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; i < ETHERNET_DRIVER_BENCHMARK_RX_POLL_MODES_NUM; i++) {
+		memset(&results[i], 0,
+			   sizeof(ethernet_driver_benchmark_rx_poll_result_t));
+
+		results[i].mode = i == 0 ? ETHERNET_DRIVER_RX_POLL_MODE_IRQ
+								 : ETHERNET_DRIVER_RX_POLL_MODE_HYBRID;
+
+		ret = benchmark_rx_poll_mode(index, duration_ms, &results[i]);
+
+		if (ret != ESP_OK) {
+			break;
+		}
+	}
+
+	ethernet_driver_rx_poll_set_mode(index,
+									 ETHERNET_DRIVER_RX_POLL_MODE_HYBRID);
+
+	return ret;
+}
+
+void ethernet_driver_benchmark_rx_poll_print(
+	const ethernet_driver_benchmark_rx_poll_result_t *results, size_t count) {
+	LOGI("%9s %9s %11s %8s %6s %9s %8s", "mode", "frames/s", "bytes/s",
+		 "dropped", "cpu(%)", "polled", "switches");
+
+	for (size_t i = 0; i < count; i++) {
+		LOGI("%9s %9" PRIu32 " %11" PRIu32 " %8" PRIu32 " %6" PRIu32
+			 " %9" PRIu32 " %8" PRIu32,
+			 results[i].mode == ETHERNET_DRIVER_RX_POLL_MODE_IRQ ? "interrupt"
+																 : "hybrid",
+			 results[i].frames_per_sec, results[i].bytes_per_sec,
+			 results[i].rx_dropped, results[i].cpu_load_percent,
+			 results[i].polled_frames, results[i].irq_to_poll);
+	}
+}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_RESTART_BENCHMARK
+	#include "esp_system.h"
+
+esp_err_t ethernet_driver_benchmark_restart_run(
+	uint32_t index, uint32_t restarts, uint32_t settle_ms,
+	ethernet_driver_benchmark_restart_result_t *result) {
+	if (result == NULL || restarts == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	uint64_t total_us   = 0;
+	uint32_t heap_start = 0;
+
+	memset(result, 0, sizeof(ethernet_driver_benchmark_restart_result_t));
+
+	result->restart_min_us = UINT32_MAX;
+
+	for (uint32_t i = 0; i <= restarts; i++) {
+		int64_t   start = esp_timer_get_time();
+		esp_err_t ret   = ethernet_driver_restart(index);
+		uint32_t  duration_us = esp_timer_get_time() - start;
+
+		if (i == 0 &&
+			(ret == ESP_ERR_INVALID_ARG || ret == ESP_ERR_INVALID_STATE)) {
+			LOGE("Interface %" PRIu32 " can not be restarted", index);
+
+			return ret;
+		}
+
+		vTaskDelay(pdMS_TO_TICKS(settle_ms));
+
+		if (i == 0) {
+			heap_start = esp_get_free_heap_size();
+			continue;
+		}
+
+		if (ret != ESP_OK) {
+			result->failures++;
+			continue;
+		}
+
+		result->restarts++;
+		total_us += duration_us;
+
+		if (duration_us < result->restart_min_us) {
+			result->restart_min_us = duration_us;
+		}
+
+		if (duration_us > result->restart_max_us) {
+			result->restart_max_us = duration_us;
+		}
+	}
+
+	if (result->restarts > 0) {
+		result->restart_avg_us = total_us / result->restarts;
+	} else {
+		result->restart_min_us = 0;
+	}
+
+	result->heap_lost     = (int32_t)(heap_start - esp_get_free_heap_size());
+	result->heap_min_free = esp_get_minimum_free_heap_size();
+
+	return result->failures == 0 ? ESP_OK : ESP_FAIL;
+}
+
+void ethernet_driver_benchmark_restart_print(
+	const ethernet_driver_benchmark_restart_result_t *result) {
+	LOGI("%8s %8s %8s %8s %8s %10s %10s", "restarts", "failures", "min(us)",
+		 "avg(us)", "max(us)", "heap lost", "heap min");
+	LOGI("%8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32
+		 " %10" PRIi32 " %10" PRIu32,
+		 result->restarts, result->failures, result->restart_min_us,
+		 result->restart_avg_us, result->restart_max_us, result->heap_lost,
+		 result->heap_min_free);
+}
+#endif // CONFIG_ETHERNET_DRIVER_RESTART_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_RX_FILTER_BENCHMARK
+	#define BENCHMARK_RX_FILTER_FRAMES_NUM 3
+	#define BENCHMARK_RX_FILTER_FRAME_LEN  64
+
+/** Broadcast ARP, SSDP multicast UDP to port 1900 and unicast TCP to 80 */
+static void benchmark_rx_filter_frames(
+	uint8_t frames[][BENCHMARK_RX_FILTER_FRAME_LEN]) {
+	static const uint8_t ssdp_mac[6] = {0x01, 0x00, 0x5E, 0x7F, 0xFF, 0xFA};
+	static const uint8_t own_mac[6]  = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+	memset(frames, 0,
+		   BENCHMARK_RX_FILTER_FRAMES_NUM * BENCHMARK_RX_FILTER_FRAME_LEN);
+
+	memset(frames[0], 0xFF, 6);
+	frames[0][12] = 0x08;
+	frames[0][13] = 0x06;
+
+	for (int i = 1; i < BENCHMARK_RX_FILTER_FRAMES_NUM; i++) {
+		uint8_t *ip = frames[i] + 14;
+
+		memcpy(frames[i], i == 1 ? ssdp_mac : own_mac, 6);
+		frames[i][12] = 0x08;
+		frames[i][13] = 0x00;
+		ip[0]         = 0x45;
+		ip[9]         = i == 1 ? 17 : 6;
+		ip[22]        = i == 1 ? 0x07 : 0x00;
+		ip[23]        = i == 1 ? 0x6C : 0x50;
+	}
+}
+
+static uint32_t benchmark_rx_filter_pass(
+	uint32_t index, uint8_t frames[][BENCHMARK_RX_FILTER_FRAME_LEN],
+	uint32_t count, uint32_t *dropped) {
+	int64_t start = esp_timer_get_time();
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (!ethernet_driver_rx_filter_accept(
+				index, frames[i % BENCHMARK_RX_FILTER_FRAMES_NUM],
+				BENCHMARK_RX_FILTER_FRAME_LEN)) {
+			(*dropped)++;
+		}
+	}
+
+	return (uint64_t)(esp_timer_get_time() - start) * 1000 / count;
+}
+
+esp_err_t ethernet_driver_benchmark_rx_filter_run(
+	uint32_t index, const ethernet_driver_rx_filter_rule_t *rules,
+	size_t count, uint32_t frames,
+	ethernet_driver_benchmark_rx_filter_result_t *result) {
+	uint8_t  mix[BENCHMARK_RX_FILTER_FRAMES_NUM][BENCHMARK_RX_FILTER_FRAME_LEN];
+	uint32_t dropped = 0;
+	ethernet_driver_rx_filter_rule_t saved[ETHERNET_DRIVER_RX_FILTER_RULES];
+	size_t                           saved_count = 0;
+
+	if (result == NULL || frames == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	// The live rules of the interface are put back afterwards
+	esp_err_t ret = ethernet_driver_rx_filter_get(index, saved, &saved_count);
+
+	if (ret == ESP_OK) {
+		ret = ethernet_driver_rx_filter_set(index, rules, count);
+	}
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	memset(result, 0, sizeof(ethernet_driver_benchmark_rx_filter_result_t));
+	benchmark_rx_filter_frames(mix);
+
+	result->frames       = frames;
+	result->ns_per_frame = benchmark_rx_filter_pass(index, mix, frames,
+													&result->dropped);
+
+	ethernet_driver_rx_filter_set(index, NULL, 0);
+
+	result->ns_per_frame_empty =
+		benchmark_rx_filter_pass(index, mix, frames, &dropped);
+
+	return ethernet_driver_rx_filter_set(index, saved, saved_count);
+}
+
+void ethernet_driver_benchmark_rx_filter_print(
+	const ethernet_driver_benchmark_rx_filter_result_t *result) {
+	LOGI("%9s %9s %9s %11s", "frames", "dropped", "ns/frame", "no rules ns");
+	LOGI("%9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %11" PRIu32, result->frames,
+		 result->dropped, result->ns_per_frame, result->ns_per_frame_empty);
+}
+#endif // CONFIG_ETHERNET_DRIVER_RX_FILTER_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED_BENCHMARK
+	#define BENCHMARK_TX_SCHED_BULK_LEN    1514
+	#define BENCHMARK_TX_SCHED_CONTROL_LEN 64
+	#define BENCHMARK_TX_SCHED_PCP_BULK    1
+	#define BENCHMARK_TX_SCHED_PCP_CONTROL 6
+
+// Priority tagged frame of the IEEE 802 local experimental EtherType
+static void benchmark_tx_sched_frame(uint8_t *frame, size_t length,
+									 uint8_t pcp) {
+	static const uint8_t mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+	memset(frame, 0, length);
+	memcpy(frame, mac, 6);
+	memcpy(frame + 6, mac, 6);
+	frame[12] = 0x81;
+	frame[13] = 0x00;
+	frame[14] = pcp << 5;
+	frame[16] = 0x88;
+	frame[17] = 0xB5;
+}
+
+static uint32_t benchmark_tx_sched_pending(uint32_t index) {
+	ethernet_driver_tx_sched_stats_t stats;
+	uint32_t                         pending = 0;
+
+	ethernet_driver_tx_sched_get_stats(index, &stats);
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		pending += stats.queues[i].pending;
+	}
+
+	return pending;
+}
+
+// Upper bound of the latency histogram bucket percent of the frames are in
+static uint32_t benchmark_tx_sched_percentile(
+	const ethernet_driver_tx_sched_queue_stats_t *queue, uint32_t percent) {
+	uint64_t total = 0;
+	uint64_t count = 0;
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS; i++) {
+		total += queue->latency_us[i];
+	}
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS - 1; i++) {
+		count += queue->latency_us[i];
+
+		if (total > 0 && count * 100 >= total * percent) {
+			return 32U << i;
+		}
+	}
+
+	return queue->max_latency_us;
+}
+
+esp_err_t ethernet_driver_benchmark_tx_sched_run(
+	uint32_t index, uint32_t duration_ms, uint32_t control_period_ms,
+	ethernet_driver_benchmark_tx_sched_result_t *result) {
+	ethernet_driver_tx_sched_handle_t tx_sched =
+		ethernet_driver_tx_sched_get(index);
+	uint8_t control[BENCHMARK_TX_SCHED_CONTROL_LEN];
+
+	if (tx_sched == NULL || result == NULL || control_period_ms == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	uint8_t *bulk = malloc(BENCHMARK_TX_SCHED_BULK_LEN);
+
+	if (bulk == NULL) {
+		LOGE("No memory for benchmark buffers");
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	benchmark_tx_sched_frame(bulk, BENCHMARK_TX_SCHED_BULK_LEN,
+							 BENCHMARK_TX_SCHED_PCP_BULK);
+	benchmark_tx_sched_frame(control, sizeof(control),
+							 BENCHMARK_TX_SCHED_PCP_CONTROL);
+
+	memset(result, 0, sizeof(ethernet_driver_benchmark_tx_sched_result_t));
+	ESP_ERROR_CHECK(ethernet_driver_tx_sched_reset_stats(index));
+
+	int64_t duration_us  = (int64_t)duration_ms * 1000;
+	int64_t start        = esp_timer_get_time();
+	int64_t now          = start;
+	int64_t next_control = start;
+
+	while (now - start < duration_us) {
+		if (now >= next_control) {
+			if (ethernet_driver_tx_sched_send(tx_sched, control,
+											  sizeof(control),
+											  NULL) == ESP_OK) {
+				result->control_frames++;
+			}
+
+			next_control += (int64_t)control_period_ms * 1000;
+		}
+
+		if (ethernet_driver_tx_sched_send(tx_sched, bulk,
+										  BENCHMARK_TX_SCHED_BULK_LEN,
+										  NULL) == ESP_OK) {
+			result->bulk_frames++;
+		} else {
+			// Bulk queue is at its depth, let the TX task drain it
+			vTaskDelay(1);
+		}
+
+		now = esp_timer_get_time();
+	}
+
+	// A rate capped bulk queue may take a while to drain
+	while (benchmark_tx_sched_pending(index) > 0 &&
+		   esp_timer_get_time() - now < duration_us) {
+		vTaskDelay(1);
+	}
+
+	free(bulk);
+
+	return ethernet_driver_tx_sched_get_stats(index, &result->stats);
+}
+
+void ethernet_driver_benchmark_tx_sched_print(
+	const ethernet_driver_benchmark_tx_sched_result_t *result) {
+	LOGI("%9s %9s %9s %9s", "bulk", "control", "throttled", "max burst");
+	LOGI("%9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32,
+		 result->bulk_frames, result->control_frames,
+		 result->stats.throttled, result->stats.max_burst);
+	LOGI("%5s %9s %9s %9s %9s %9s", "queue", "sent", "dropped", "p50(us)",
+		 "p99(us)", "max(us)");
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		const ethernet_driver_tx_sched_queue_stats_t *queue =
+			&result->stats.queues[i];
+
+		LOGI("%5d %9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32
+			 " %9" PRIu32,
+			 i, queue->sent_frames, queue->dropped,
+			 benchmark_tx_sched_percentile(queue, 50),
+			 benchmark_tx_sched_percentile(queue, 99), queue->max_latency_us);
+	}
+}
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_CHKSUM_BENCHMARK
+	// Where the IP header of a frame starts, only 2-byte aligned
+	#define BENCHMARK_CHKSUM_OFFSET 14
+
+static const uint32_t
+	s_chksum_lengths[ETHERNET_DRIVER_BENCHMARK_CHKSUM_LENGTHS_NUM] = {
+		20, 64, 576, 1500};
+
+static volatile uint16_t s_chksum_sink;
+
+/** lwip_standard_chksum() of LWIP_CHKSUM_ALGORITHM 2, lwIP's default */
+static uint16_t benchmark_chksum_reference(const void *data, int length) {
+	const uint8_t  *bytes = data;
+	const uint16_t *words;
+	uint16_t        edge = 0;
+	uint32_t        sum  = 0;
+	int             odd  = ((uintptr_t)bytes & 1);
+
+	if (odd && length > 0) {
+		((uint8_t *)&edge)[1] = *bytes++;
+		length--;
+	}
+
+	words = (const uint16_t *)(const void *)bytes;
+
+	while (length > 1) {
+		sum    += *words++;
+		length -= 2;
+	}
+
+	if (length > 0) {
+		((uint8_t *)&edge)[0] = *(const uint8_t *)words;
+	}
+
+	sum += edge;
+	sum  = (sum >> 16) + (sum & 0xFFFF);
+	sum  = (sum >> 16) + (sum & 0xFFFF);
+
+	if (odd) {
+		sum = ((sum & 0xFF) << 8) | ((sum & 0xFF00) >> 8);
+	}
+
+	return sum;
+}
+
+static uint16_t benchmark_chksum_copy_reference(void *dst, const void *src,
+												uint16_t length) {
+	memcpy(dst, src, length);
+
+	return benchmark_chksum_reference(dst, length);
+}
+
+static uint32_t benchmark_chksum_pass(uint16_t (*chksum)(const void *, int),
+									  const uint8_t *data, uint32_t length,
+									  uint32_t iterations) {
+	int64_t start = esp_timer_get_time();
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		s_chksum_sink = chksum(data, length);
+	}
+
+	return (uint64_t)(esp_timer_get_time() - start) * 1000 / iterations;
+}
+
+static uint32_t benchmark_chksum_copy_pass(
+	uint16_t (*chksum_copy)(void *, const void *, uint16_t), uint8_t *dst,
+	const uint8_t *src, uint32_t length, uint32_t iterations) {
+	int64_t start = esp_timer_get_time();
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		s_chksum_sink = chksum_copy(dst, src, length);
+	}
+
+	return (uint64_t)(esp_timer_get_time() - start) * 1000 / iterations;
+}
+
+esp_err_t ethernet_driver_benchmark_chksum_run(
+	uint32_t iterations, ethernet_driver_benchmark_chksum_result_t *results) {
+	uint32_t size   = BENCHMARK_CHKSUM_OFFSET + ETH_MAX_PACKET_SIZE;
+	uint32_t random = 0x12345678;
+
+	if (results == NULL || iterations == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	uint8_t *src = malloc(size);
+	uint8_t *dst = malloc(size);
+
+	if (src == NULL || dst == NULL) {
+		LOGE("No memory for benchmark buffers");
+
+		free(src);
+		free(dst);
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	// Any data, as long as every run sums the same
+	for (uint32_t i = 0; i < size; i++) {
+		random = random * 1664525 + 1013904223;
+		src[i] = random >> 24;
+	}
+
+	memset(results, 0,
+		   ETHERNET_DRIVER_BENCHMARK_CHKSUM_LENGTHS_NUM *
+			   sizeof(ethernet_driver_benchmark_chksum_result_t));
+
+	for (int i = 0; i < ETHERNET_DRIVER_BENCHMARK_CHKSUM_LENGTHS_NUM; i++) {
+		ethernet_driver_benchmark_chksum_result_t *result = &results[i];
+		uint32_t       length = s_chksum_lengths[i];
+		const uint8_t *data   = src + BENCHMARK_CHKSUM_OFFSET;
+		uint8_t       *copy   = dst + BENCHMARK_CHKSUM_OFFSET;
+
+		result->length = length;
+
+		// Every alignment of the start and both parities of the length
+		for (uint32_t offset = 0; offset < 4; offset++) {
+			for (uint32_t trim = 0; trim < 2; trim++) {
+				uint16_t expected =
+					benchmark_chksum_reference(data + offset, length - trim);
+
+				if (ethernet_driver_chksum(data + offset, length - trim) !=
+						expected ||
+					ethernet_driver_chksum_copy(copy + offset, data + offset,
+												length - trim) != expected ||
+					memcmp(copy + offset, data + offset, length - trim) != 0) {
+					result->mismatches++;
+				}
+			}
+		}
+
+		result->ns_reference = benchmark_chksum_pass(
+			benchmark_chksum_reference, data, length, iterations);
+		result->ns_chksum = benchmark_chksum_pass(ethernet_driver_chksum, data,
+												  length, iterations);
+		result->ns_copy_reference = benchmark_chksum_copy_pass(
+			benchmark_chksum_copy_reference, copy, data, length, iterations);
+		result->ns_copy = benchmark_chksum_copy_pass(
+			ethernet_driver_chksum_copy, copy, data, length, iterations);
+	}
+
+	free(src);
+	free(dst);
+
+	return ESP_OK;
+}
+
+void ethernet_driver_benchmark_chksum_print(
+	const ethernet_driver_benchmark_chksum_result_t *results) {
+	LOGI("%6s %9s %9s %9s %9s %10s", "length", "lwip ns", "chksum ns",
+		 "lwip cp", "copy ns", "mismatches");
+
+	for (int i = 0; i < ETHERNET_DRIVER_BENCHMARK_CHKSUM_LENGTHS_NUM; i++) {
+		const ethernet_driver_benchmark_chksum_result_t *result = &results[i];
+
+		LOGI("%6" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32
+			 " %10" PRIu32,
+			 result->length, result->ns_reference, result->ns_chksum,
+			 result->ns_copy_reference, result->ns_copy, result->mismatches);
+	}
+}
+#endif // CONFIG_ETHERNET_DRIVER_CHKSUM_BENCHMARK
@@ -0,0 +1,229 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_boot.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+
+#include "log_utils.h"
+
+#include "ethernet_driver.h"
+#include "ethernet_driver_boot.h"
+
+LOG_TAG("ethernet_driver_boot");
+
+_Static_assert(ETHERNET_DRIVER_ETHERNETS_NUM <= 8,
+			   "Event group holds the bits of up to 8 interfaces");
+
+typedef struct boot_interface_s {
+	esp_netif_t                 *netif;
+	esp_eth_handle_t             eth_handle;
+	ethernet_driver_boot_trace_t trace;
+} boot_interface_t;
+
+static EventGroupHandle_t         s_event_group;
+static int64_t                    s_init_us;
+static ethernet_driver_ready_cb_t s_ready_cb;
+static void                      *s_ready_cb_arg;
+static boot_interface_t           s_interfaces[ETHERNET_DRIVER_ETHERNETS_NUM];
+
+static int32_t boot_elapsed_ms(void) {
+	return (esp_timer_get_time() - s_init_us) / 1000;
+}
+
+static void boot_eth_event_handler(void *arg, esp_event_base_t event_base,
+								   int32_t event_id, void *event_data) {
+	esp_eth_handle_t eth_handle = *(esp_eth_handle_t *)event_data;
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_interfaces[i].eth_handle != eth_handle) {
+			continue;
+		}
+
+		if (event_id == ETHERNET_EVENT_CONNECTED) {
+			if (s_interfaces[i].trace.link_up_ms < 0) {
+				s_interfaces[i].trace.link_up_ms = boot_elapsed_ms();
+			}
+
+			xEventGroupSetBits(s_event_group, ETHERNET_DRIVER_LINK_UP_BIT(i));
+		} else if (event_id == ETHERNET_EVENT_DISCONNECTED) {
+			xEventGroupClearBits(s_event_group,
+								 ETHERNET_DRIVER_LINK_UP_BIT(i));
+		}
+
+		break;
+	}
+}
+
+static void boot_ip_event_handler(void *arg, esp_event_base_t event_base,
+								  int32_t event_id, void *event_data) {
+	ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_interfaces[i].netif != event->esp_netif) {
+			continue;
+		}
+
+		if (event_id == IP_EVENT_ETH_LOST_IP) {
+			xEventGroupClearBits(s_event_group, ETHERNET_DRIVER_GOT_IP_BIT(i));
+			break;
+		}
+
+		xEventGroupSetBits(s_event_group, ETHERNET_DRIVER_GOT_IP_BIT(i));
+
+		if (s_interfaces[i].trace.got_ip_ms < 0) {
+			s_interfaces[i].trace.got_ip_ms = boot_elapsed_ms();
+
+			LOGI("Interface %" PRIu32 " link up in %" PRIi32
+				 " ms, got IP in %" PRIi32 " ms",
+				 i, s_interfaces[i].trace.link_up_ms,
+				 s_interfaces[i].trace.got_ip_ms);
+
+			if (s_ready_cb != NULL) {
+				s_ready_cb(i, ESP_OK, s_ready_cb_arg);
+			}
+		}
+
+		break;
+	}
+}
+
+EventGroupHandle_t ethernet_driver_get_event_group(void) {
+	return s_event_group;
+}
+
+esp_err_t ethernet_driver_get_boot_trace(uint32_t                      index,
+										 ethernet_driver_boot_trace_t *trace) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || trace == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	*trace = s_interfaces[index].trace;
+
+	return ESP_OK;
+}
+
+void ethernet_driver_print_boot_trace(void) {
+	LOGI("%5s %12s %11s %s", "index", "link up(ms)", "got IP(ms)", "status");
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		LOGI("%5" PRIu32 " %12" PRIi32 " %11" PRIi32 " %s", i,
+			 s_interfaces[i].trace.link_up_ms, s_interfaces[i].trace.got_ip_ms,
+			 esp_err_to_name(s_interfaces[i].trace.status));
+	}
+}
+
+esp_err_t ethernet_driver_boot_start(ethernet_driver_ready_cb_t ready_cb,
+									 void                      *arg) {
+	if (s_event_group == NULL) {
+		s_event_group = xEventGroupCreate();
+
+		if (s_event_group == NULL) {
+			LOGE("No memory for the event group");
+
+			return ESP_ERR_NO_MEM;
+		}
+
+		esp_err_t ret = esp_event_handler_register(
+			ETH_EVENT, ESP_EVENT_ANY_ID, &boot_eth_event_handler, NULL);
+
+		if (ret == ESP_OK) {
+			ret = esp_event_handler_register(IP_EVENT, IP_EVENT_ETH_GOT_IP,
+											 &boot_ip_event_handler, NULL);
+		}
+
+		if (ret == ESP_OK) {
+			ret = esp_event_handler_register(IP_EVENT, IP_EVENT_ETH_LOST_IP,
+											 &boot_ip_event_handler, NULL);
+		}
+
+		if (ret != ESP_OK) {
+			LOGE("Could not register boot event handlers");
+
+			return ret;
+		}
+	}
+
+	xEventGroupClearBits(s_event_group, 0x00FFFFFF);
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		s_interfaces[i].netif            = NULL;
+		s_interfaces[i].eth_handle       = NULL;
+		s_interfaces[i].trace.link_up_ms = -1;
+		s_interfaces[i].trace.got_ip_ms  = -1;
+		s_interfaces[i].trace.status     = ESP_OK;
+	}
+
+	s_ready_cb     = ready_cb;
+	s_ready_cb_arg = arg;
+	s_init_us      = esp_timer_get_time();
+
+	return ESP_OK;
+}
+
+void ethernet_driver_boot_register(uint32_t index, esp_netif_t *netif,
+								   esp_eth_handle_t eth_handle) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	s_interfaces[index].netif      = netif;
+	s_interfaces[index].eth_handle = eth_handle;
+}
+
+void ethernet_driver_boot_failed(uint32_t index, esp_err_t status) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	s_interfaces[index].trace.status = status;
+
+	xEventGroupSetBits(s_event_group, ETHERNET_DRIVER_FAILED_BIT(index));
+
+	if (s_ready_cb != NULL) {
+		s_ready_cb(index, status, s_ready_cb_arg);
+	}
+}
+
+uint32_t ethernet_driver_boot_find_index(esp_netif_t     *netif,
+										 esp_eth_handle_t eth_handle) {
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if ((netif != NULL && s_interfaces[i].netif == netif) ||
+			(eth_handle != NULL && s_interfaces[i].eth_handle == eth_handle)) {
+			return i;
+		}
+	}
+
+	return ETHERNET_DRIVER_ETHERNETS_NUM;
+}
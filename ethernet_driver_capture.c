@@ -0,0 +1,372 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_capture.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_CAPTURE
+
+	#include "freertos/FreeRTOS.h"
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_capture.h"
+
+LOG_TAG("ethernet_driver_capture");
+
+	#define CAPTURE_RING_MASK      (ETHERNET_DRIVER_CAPTURE_RING_SIZE - 1)
+	#define CAPTURE_PCAP_MAGIC     0xA1B2C3D4
+	#define CAPTURE_LINKTYPE_EN10M 1
+	#define CAPTURE_ETH_TYPE_VLAN  0x8100
+
+typedef struct capture_file_header_s {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t  thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t linktype;
+} capture_file_header_t;
+
+typedef struct capture_record_header_s {
+	uint32_t ts_sec;
+	uint32_t ts_usec;
+	uint32_t incl_len;
+	uint32_t orig_len;
+} capture_record_header_t;
+
+/**
+ * Records are stored back to back, wrapping at the end of the ring. head
+ * and tail only grow, writers advance head under s_lock and the single
+ * reader copies out before it gives the space back by advancing tail.
+ */
+static uint8_t      s_ring[ETHERNET_DRIVER_CAPTURE_RING_SIZE];
+static uint32_t     s_head;
+static uint32_t     s_tail;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static _Atomic bool s_running;
+static _Atomic bool s_reading;
+
+// Written and copied under s_lock
+static ethernet_driver_capture_filter_t s_filter =
+	ETHERNET_DRIVER_CAPTURE_FILTER_DEFAULT();
+
+static _Atomic uint32_t s_captured;
+static _Atomic uint32_t s_truncated;
+static _Atomic uint32_t s_filtered;
+static _Atomic uint32_t s_dropped;
+
+static void capture_ring_put(uint32_t offset, const void *data, size_t size) {
+	uint32_t start = offset & CAPTURE_RING_MASK;
+	size_t   first = ETHERNET_DRIVER_CAPTURE_RING_SIZE - start;
+
+	if (first > size) {
+		first = size;
+	}
+
+	memcpy(s_ring + start, data, first);
+	memcpy(s_ring, (const uint8_t *)data + first, size - first);
+}
+
+static void capture_ring_get(uint32_t offset, void *data, size_t size) {
+	uint32_t start = offset & CAPTURE_RING_MASK;
+	size_t   first = ETHERNET_DRIVER_CAPTURE_RING_SIZE - start;
+
+	if (first > size) {
+		first = size;
+	}
+
+	memcpy(data, s_ring + start, first);
+	memcpy((uint8_t *)data + first, s_ring, size - first);
+}
+
+static bool capture_match(const ethernet_driver_capture_filter_t *filter,
+						  uint32_t index, uint32_t direction,
+						  const uint8_t *frame, size_t length) {
+	if (index >= 32 || (filter->index_mask & (1U << index)) == 0 ||
+		(filter->directions & direction) == 0) {
+		return false;
+	}
+
+	if (filter->ethertype == 0) {
+		return true;
+	}
+
+	if (length < ETH_HEADER_LEN) {
+		return false;
+	}
+
+	uint32_t ethertype = (frame[12] << 8) | frame[13];
+
+	if (ethertype == CAPTURE_ETH_TYPE_VLAN && length >= ETH_HEADER_LEN + 4) {
+		ethertype = (frame[16] << 8) | frame[17];
+	}
+
+	return ethertype == filter->ethertype;
+}
+
+void ethernet_driver_capture_frame(uint32_t index, uint32_t direction,
+								   const uint8_t *frame, size_t length) {
+	ethernet_driver_capture_filter_t filter;
+
+	if (!atomic_load_explicit(&s_running, memory_order_acquire)) {
+		return;
+	}
+
+	// A stop and start may replace the filter while this frame is handled
+	portENTER_CRITICAL(&s_lock);
+	filter = s_filter;
+	portEXIT_CRITICAL(&s_lock);
+
+	if (!capture_match(&filter, index, direction, frame, length)) {
+		RELAXED_ADD(s_filtered, 1);
+
+		return;
+	}
+
+	uint32_t                incl_len = length;
+	capture_record_header_t header;
+	struct timeval          now;
+
+	if (incl_len > filter.snaplen) {
+		incl_len = filter.snaplen;
+	}
+
+	gettimeofday(&now, NULL);
+
+	header.ts_sec   = now.tv_sec;
+	header.ts_usec  = now.tv_usec;
+	header.incl_len = incl_len;
+	header.orig_len = length;
+
+	uint32_t size = sizeof(header) + incl_len;
+
+	// Bounded by snaplen, only the truncated bytes are copied
+	portENTER_CRITICAL(&s_lock);
+
+	if (ETHERNET_DRIVER_CAPTURE_RING_SIZE - (s_head - s_tail) < size) {
+		portEXIT_CRITICAL(&s_lock);
+		RELAXED_ADD(s_dropped, 1);
+
+		return;
+	}
+
+	capture_ring_put(s_head, &header, sizeof(header));
+	capture_ring_put(s_head + sizeof(header), frame, incl_len);
+	s_head += size;
+
+	portEXIT_CRITICAL(&s_lock);
+
+	RELAXED_ADD(s_captured, 1);
+
+	if (incl_len < length) {
+		RELAXED_ADD(s_truncated, 1);
+	}
+}
+
+esp_err_t ethernet_driver_capture_start(
+	const ethernet_driver_capture_filter_t *filter) {
+	// A record that never fits would drop every frame
+	if (filter == NULL || filter->snaplen == 0 ||
+		filter->snaplen > ETH_MAX_PACKET_SIZE ||
+		sizeof(capture_record_header_t) + filter->snaplen >
+			ETHERNET_DRIVER_CAPTURE_RING_SIZE) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	esp_err_t ret = ESP_OK;
+
+	// Writers of the previous run copy the filter under the same lock
+	portENTER_CRITICAL(&s_lock);
+
+	if (atomic_load(&s_running)) {
+		ret = ESP_ERR_INVALID_STATE;
+	} else {
+		s_filter = *filter;
+		atomic_store_explicit(&s_running, true, memory_order_release);
+	}
+
+	portEXIT_CRITICAL(&s_lock);
+
+	return ret;
+}
+
+esp_err_t ethernet_driver_capture_stop(void) {
+	atomic_store(&s_running, false);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_capture_get_stats(
+	ethernet_driver_capture_stats_t *stats) {
+	if (stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	stats->captured  = RELAXED_LOAD(s_captured);
+	stats->truncated = RELAXED_LOAD(s_truncated);
+	stats->filtered  = RELAXED_LOAD(s_filtered);
+	stats->dropped   = RELAXED_LOAD(s_dropped);
+
+	portENTER_CRITICAL(&s_lock);
+	stats->ring_used = s_head - s_tail;
+	portEXIT_CRITICAL(&s_lock);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_capture_reset_stats(void) {
+	RELAXED_CLEAR(s_captured);
+	RELAXED_CLEAR(s_truncated);
+	RELAXED_CLEAR(s_filtered);
+	RELAXED_CLEAR(s_dropped);
+
+	return ESP_OK;
+}
+
+void ethernet_driver_capture_header(void *header) {
+	capture_file_header_t file_header = {
+		.magic         = CAPTURE_PCAP_MAGIC,
+		.version_major = 2,
+		.version_minor = 4,
+		.linktype      = CAPTURE_LINKTYPE_EN10M,
+	};
+
+	portENTER_CRITICAL(&s_lock);
+	file_header.snaplen = s_filter.snaplen;
+	portEXIT_CRITICAL(&s_lock);
+
+	memcpy(header, &file_header, sizeof(file_header));
+}
+
+esp_err_t ethernet_driver_capture_read(void *buffer, size_t size,
+									   size_t *length) {
+	if (buffer == NULL || length == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	if (atomic_exchange(&s_reading, true)) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	uint32_t head;
+	uint32_t tail = s_tail;
+
+	portENTER_CRITICAL(&s_lock);
+	head = s_head;
+	portEXIT_CRITICAL(&s_lock);
+
+	*length = 0;
+
+	// Written records stay put until tail moves past them
+	while (tail != head) {
+		capture_record_header_t header;
+
+		capture_ring_get(tail, &header, sizeof(header));
+
+		size_t record = sizeof(header) + header.incl_len;
+
+		if (*length + record > size) {
+			break;
+		}
+
+		capture_ring_get(tail, (uint8_t *)buffer + *length, record);
+		tail    += record;
+		*length += record;
+	}
+
+	portENTER_CRITICAL(&s_lock);
+	s_tail = tail;
+	portEXIT_CRITICAL(&s_lock);
+
+	atomic_store(&s_reading, false);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_capture_dump(FILE *file) {
+	uint8_t header[ETHERNET_DRIVER_CAPTURE_HEADER_LEN];
+	size_t  size = ETHERNET_DRIVER_CAPTURE_RECORD_HEADER_LEN +
+				  ETH_MAX_PACKET_SIZE;
+
+	if (file == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	uint8_t *buffer = malloc(size);
+
+	if (buffer == NULL) {
+		LOGE("No memory for capture dump");
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	ethernet_driver_capture_header(header);
+
+	esp_err_t ret = ESP_OK;
+	size_t    length;
+
+	if (fwrite(header, sizeof(header), 1, file) != 1) {
+		ret = ESP_FAIL;
+	}
+
+	// Frames captured while writing are left for the next dump
+	portENTER_CRITICAL(&s_lock);
+	uint32_t left = s_head - s_tail;
+	portEXIT_CRITICAL(&s_lock);
+
+	while (ret == ESP_OK && left > 0) {
+		ret = ethernet_driver_capture_read(buffer, size < left ? size : left,
+										   &length);
+
+		if (ret != ESP_OK || length == 0) {
+			break;
+		}
+
+		if (fwrite(buffer, length, 1, file) != 1) {
+			ret = ESP_FAIL;
+		}
+
+		left -= length;
+	}
+
+	free(buffer);
+
+	if (ret != ESP_OK) {
+		LOGE("Could not dump capture: %s", esp_err_to_name(ret));
+	}
+
+	return ret;
+}
+#endif // CONFIG_ETHERNET_DRIVER_CAPTURE
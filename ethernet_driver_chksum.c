@@ -0,0 +1,166 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_chksum.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_CHKSUM
+
+	#include "ethernet_driver_chksum.h"
+
+// Loads of the byte buffers lwIP hands over as words
+typedef uint16_t __attribute__((may_alias)) chksum_u16_t;
+typedef uint32_t __attribute__((may_alias)) chksum_u32_t;
+
+/**
+ * Sum native 32-bit words into a 64-bit accumulator, which takes the
+ * carries of any frame, and fold once at the end. The one's complement sum
+ * does not depend on byte order, only on which bytes are paired: from an
+ * odd address the pairs are shifted by one, which swaps the bytes of the
+ * result. With copy the data is written there along the way, copy must be
+ * aligned like data.
+ */
+static inline __attribute__((always_inline)) uint16_t chksum_kernel(
+	const uint8_t *data, int length, uint8_t *copy) {
+	uint64_t sum  = 0;
+	bool     odd  = ((uintptr_t)data & 1) != 0;
+	uint16_t edge = 0;
+
+	if (length <= 0) {
+		return 0;
+	}
+
+	if (odd) {
+		((uint8_t *)&edge)[1] = *data;
+
+		if (copy != NULL) {
+			*copy++ = *data;
+		}
+
+		data++;
+		length--;
+		sum += edge;
+	}
+
+	if (((uintptr_t)data & 2) != 0 && length >= 2) {
+		sum += *(const chksum_u16_t *)data;
+
+		if (copy != NULL) {
+			*(chksum_u16_t *)copy  = *(const chksum_u16_t *)data;
+			copy                  += 2;
+		}
+
+		data   += 2;
+		length -= 2;
+	}
+
+	const chksum_u32_t *words = (const chksum_u32_t *)data;
+	chksum_u32_t       *out   = (chksum_u32_t *)copy;
+
+	while (length >= 32) {
+		sum += (uint64_t)words[0] + words[1] + words[2] + words[3] +
+			   words[4] + words[5] + words[6] + words[7];
+
+		if (out != NULL) {
+			out[0]  = words[0];
+			out[1]  = words[1];
+			out[2]  = words[2];
+			out[3]  = words[3];
+			out[4]  = words[4];
+			out[5]  = words[5];
+			out[6]  = words[6];
+			out[7]  = words[7];
+			out    += 8;
+		}
+
+		words  += 8;
+		length -= 32;
+	}
+
+	while (length >= 4) {
+		sum += *words;
+
+		if (out != NULL) {
+			*out++ = *words;
+		}
+
+		words++;
+		length -= 4;
+	}
+
+	data = (const uint8_t *)words;
+	copy = (uint8_t *)out;
+
+	if (length >= 2) {
+		sum += *(const chksum_u16_t *)data;
+
+		if (copy != NULL) {
+			*(chksum_u16_t *)copy  = *(const chksum_u16_t *)data;
+			copy                  += 2;
+		}
+
+		data   += 2;
+		length -= 2;
+	}
+
+	if (length > 0) {
+		edge                  = 0;
+		((uint8_t *)&edge)[0] = *data;
+		sum                  += edge;
+
+		if (copy != NULL) {
+			*copy = *data;
+		}
+	}
+
+	while (sum >> 16) {
+		sum = (sum >> 16) + (sum & 0xFFFF);
+	}
+
+	if (odd) {
+		sum = ((sum & 0xFF) << 8) | (sum >> 8);
+	}
+
+	return sum;
+}
+
+uint16_t ethernet_driver_chksum(const void *data, int length) {
+	return chksum_kernel(data, length, NULL);
+}
+
+uint16_t ethernet_driver_chksum_copy(void *dst, const void *src,
+									 uint16_t length) {
+	// Word stores need dst aligned like src
+	if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) != 0) {
+		memcpy(dst, src, length);
+
+		return chksum_kernel(dst, length, NULL);
+	}
+
+	return chksum_kernel(src, length, dst);
+}
+#endif // CONFIG_ETHERNET_DRIVER_CHKSUM
@@ -0,0 +1,351 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_failover.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_FAILOVER
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/event_groups.h"
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+	#include "esp_event.h"
+	#include "esp_netif.h"
+	#include "esp_timer.h"
+
+	#include "lwip/etharp.h"
+	#include "lwip/tcpip.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_failover.h"
+
+LOG_TAG("ethernet_driver_failover");
+
+/**
+ * The PHY gets mediator instead of the one of the esp_eth driver, so link
+ * changes are seen in the poll that detects them.
+ */
+typedef struct failover_member_s {
+	esp_eth_mediator_t  mediator;
+	esp_eth_mediator_t *eth;
+	esp_eth_phy_t      *phy;
+	esp_netif_t        *netif;
+	esp_eth_handle_t   *eth_handle;
+	bool                link_up;
+	_Atomic uint32_t    poll_us;
+	_Atomic uint32_t    last_poll_us;
+	_Atomic uint32_t    lost_after_us;
+	esp_err_t (*set_mediator)(esp_eth_phy_t *phy, esp_eth_mediator_t *eth);
+	esp_err_t (*get_link)(esp_eth_phy_t *phy);
+	esp_err_t (*del)(esp_eth_phy_t *phy);
+} failover_member_t;
+
+static failover_member_t s_members[ETHERNET_DRIVER_ETHERNETS_NUM];
+static bool              s_handlers_registered;
+static _Atomic uint32_t  s_failovers;
+static _Atomic uint32_t  s_failbacks;
+static _Atomic uint32_t  s_no_survivor;
+static _Atomic uint32_t  s_latency_ms[ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS];
+
+static failover_member_t *failover_find(esp_eth_phy_t *phy) {
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_members[i].phy == phy) {
+			return &s_members[i];
+		}
+	}
+
+	return NULL;
+}
+
+static esp_err_t failover_phy_reg_read(esp_eth_mediator_t *eth,
+									   uint32_t phy_addr, uint32_t phy_reg,
+									   uint32_t *reg_value) {
+	failover_member_t *member = (failover_member_t *)eth;
+
+	return member->eth->phy_reg_read(member->eth, phy_addr, phy_reg,
+									 reg_value);
+}
+
+static esp_err_t failover_phy_reg_write(esp_eth_mediator_t *eth,
+										uint32_t phy_addr, uint32_t phy_reg,
+										uint32_t reg_value) {
+	failover_member_t *member = (failover_member_t *)eth;
+
+	return member->eth->phy_reg_write(member->eth, phy_addr, phy_reg,
+									  reg_value);
+}
+
+static esp_err_t failover_stack_input(esp_eth_mediator_t *eth,
+									  uint8_t *buffer, uint32_t length) {
+	failover_member_t *member = (failover_member_t *)eth;
+
+	return member->eth->stack_input(member->eth, buffer, length);
+}
+
+static esp_err_t failover_on_state_changed(esp_eth_mediator_t *eth,
+										   esp_eth_state_t     state,
+										   void               *args) {
+	failover_member_t *member = (failover_member_t *)eth;
+	eth_link_t         link   = (eth_link_t)(uintptr_t)args;
+
+	// Called from the poll that lost the link, the one before still had it
+	if (state == ETH_STATE_LINK && link == ETH_LINK_DOWN) {
+		RELAXED_STORE(member->lost_after_us,
+					  RELAXED_LOAD(member->last_poll_us));
+	}
+
+	return member->eth->on_state_changed(member->eth, state, args);
+}
+
+static esp_err_t failover_hook_set_mediator(esp_eth_phy_t      *phy,
+											esp_eth_mediator_t *eth) {
+	failover_member_t *member = failover_find(phy);
+
+	member->eth = eth;
+
+	return member->set_mediator(phy, &member->mediator);
+}
+
+static esp_err_t failover_hook_get_link(esp_eth_phy_t *phy) {
+	failover_member_t *member = failover_find(phy);
+
+	RELAXED_STORE(member->last_poll_us, RELAXED_LOAD(member->poll_us));
+	RELAXED_STORE(member->poll_us, (uint32_t)esp_timer_get_time());
+
+	return member->get_link(phy);
+}
+
+static esp_err_t failover_hook_del(esp_eth_phy_t *phy) {
+	failover_member_t *member = failover_find(phy);
+	esp_err_t (*del)(esp_eth_phy_t *phy) = member->del;
+
+	memset(member, 0, sizeof(failover_member_t));
+
+	return del(phy);
+}
+
+/** Interface with the highest route priority whose link is up with an IP */
+static esp_netif_t *failover_best(void) {
+	EventBits_t bits = xEventGroupGetBits(ethernet_driver_get_event_group());
+	esp_netif_t *best      = NULL;
+	int          best_prio = -1;
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_members[i].netif == NULL || !s_members[i].link_up ||
+			(bits & ETHERNET_DRIVER_GOT_IP_BIT(i)) == 0) {
+			continue;
+		}
+
+		int prio = esp_netif_get_route_prio(s_members[i].netif);
+
+		if (prio > best_prio) {
+			best      = s_members[i].netif;
+			best_prio = prio;
+		}
+	}
+
+	return best;
+}
+
+// Runs in the tcpip thread
+static void failover_announce(void *arg) {
+	struct netif *netif = arg;
+
+	if (netif_is_up(netif)) {
+		etharp_gratuitous(netif);
+	}
+}
+
+static void failover_move_default(esp_netif_t *netif) {
+	esp_netif_set_default_netif(netif);
+
+	// Peers refresh the address of the interface now carrying the traffic
+	if (tcpip_callback(failover_announce, esp_netif_get_netif_impl(netif)) !=
+		ERR_OK) {
+		LOGW("Could not announce %s", esp_netif_get_desc(netif));
+	}
+}
+
+static void failover_link_down(uint32_t index) {
+	failover_member_t *member = &s_members[index];
+
+	member->link_up = false;
+
+	if (esp_netif_get_default_netif() != member->netif) {
+		return;
+	}
+
+	esp_netif_t *best = failover_best();
+
+	if (best == NULL) {
+		RELAXED_ADD(s_no_survivor, 1);
+		LOGW("Interface %" PRIu32 " down, no other interface up", index);
+
+		return;
+	}
+
+	failover_move_default(best);
+
+	uint32_t lost_after_us = RELAXED_LOAD(member->lost_after_us);
+	uint32_t now_us        = (uint32_t)esp_timer_get_time();
+	uint32_t latency_ms =
+		(lost_after_us == 0 ? 0 : now_us - lost_after_us) / 1000;
+	uint32_t bucket = latency_ms == 0 ? 0 : 32 - __builtin_clz(latency_ms);
+
+	if (bucket >= ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS) {
+		bucket = ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS - 1;
+	}
+
+	RELAXED_ADD(s_failovers, 1);
+	RELAXED_ADD(s_latency_ms[bucket], 1);
+
+	LOGW("Interface %" PRIu32 " down, default route on %s within %" PRIu32
+		 " ms",
+		 index, esp_netif_get_desc(best), latency_ms);
+}
+
+static void failover_eth_event_handler(void *arg, esp_event_base_t event_base,
+									   int32_t event_id, void *event_data) {
+	esp_eth_handle_t eth_handle = *(esp_eth_handle_t *)event_data;
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_members[i].eth_handle == NULL ||
+			*s_members[i].eth_handle != eth_handle) {
+			continue;
+		}
+
+		if (event_id == ETHERNET_EVENT_CONNECTED) {
+			s_members[i].link_up = true;
+		} else if (event_id == ETHERNET_EVENT_DISCONNECTED) {
+			failover_link_down(i);
+		}
+
+		break;
+	}
+}
+
+// A preferred interface coming back takes the default route again
+static void failover_ip_event_handler(void *arg, esp_event_base_t event_base,
+									  int32_t event_id, void *event_data) {
+	esp_netif_t *best    = failover_best();
+	esp_netif_t *current = esp_netif_get_default_netif();
+
+	if (best != NULL && best != current &&
+		(current == NULL || esp_netif_get_route_prio(best) >
+								esp_netif_get_route_prio(current))) {
+		failover_move_default(best);
+		RELAXED_ADD(s_failbacks, 1);
+	}
+}
+
+esp_err_t ethernet_driver_failover_get_stats(
+	ethernet_driver_failover_stats_t *stats) {
+	if (stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	stats->failovers   = RELAXED_LOAD(s_failovers);
+	stats->failbacks   = RELAXED_LOAD(s_failbacks);
+	stats->no_survivor = RELAXED_LOAD(s_no_survivor);
+
+	for (int i = 0; i < ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS; i++) {
+		stats->latency_ms[i] = RELAXED_LOAD(s_latency_ms[i]);
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_failover_reset_stats(void) {
+	RELAXED_STORE(s_failovers, 0);
+	RELAXED_STORE(s_failbacks, 0);
+	RELAXED_STORE(s_no_survivor, 0);
+
+	for (int i = 0; i < ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS; i++) {
+		RELAXED_STORE(s_latency_ms[i], 0);
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_failover_attach(uint32_t index, esp_netif_t *netif,
+										  esp_eth_phy_t    *phy,
+										  esp_eth_handle_t *eth_handle) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || netif == NULL ||
+		phy == NULL || eth_handle == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	failover_member_t *member = &s_members[index];
+
+	if (member->phy != NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	if (!s_handlers_registered) {
+		esp_err_t ret = esp_event_handler_register(
+			ETH_EVENT, ESP_EVENT_ANY_ID, &failover_eth_event_handler, NULL);
+
+		if (ret == ESP_OK) {
+			ret = esp_event_handler_register(IP_EVENT, IP_EVENT_ETH_GOT_IP,
+											 &failover_ip_event_handler, NULL);
+		}
+
+		if (ret != ESP_OK) {
+			LOGE("Could not register failover event handlers");
+
+			return ret;
+		}
+
+		s_handlers_registered = true;
+	}
+
+	member->mediator.phy_reg_read     = failover_phy_reg_read;
+	member->mediator.phy_reg_write    = failover_phy_reg_write;
+	member->mediator.stack_input      = failover_stack_input;
+	member->mediator.on_state_changed = failover_on_state_changed;
+
+	member->netif        = netif;
+	member->eth_handle   = eth_handle;
+	member->set_mediator = phy->set_mediator;
+	member->get_link     = phy->get_link;
+	member->del          = phy->del;
+	member->phy          = phy;
+
+	phy->set_mediator = failover_hook_set_mediator;
+	phy->get_link     = failover_hook_get_link;
+	phy->del          = failover_hook_del;
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_FAILOVER
@@ -0,0 +1,186 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_frame_pool.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	#include "freertos/FreeRTOS.h"
+
+	#include "esp_err.h"
+	#include "esp_heap_caps.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver_frame_pool.h"
+
+LOG_TAG("ethernet_driver_frame_pool");
+
+/** Called with the lock released, once no buffer is in use */
+static void frame_pool_free_memory(ethernet_driver_frame_pool_t *pool) {
+	heap_caps_free(pool->arena);
+	free(pool->free_list);
+	free(pool);
+}
+
+esp_err_t ethernet_driver_frame_pool_new(uint32_t buffer_count,
+										 uint32_t buffer_size,
+										 ethernet_driver_frame_pool_t **out) {
+	if (out == NULL || buffer_count == 0 || buffer_count > UINT16_MAX) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	ethernet_driver_frame_pool_t *pool =
+		calloc(1, sizeof(ethernet_driver_frame_pool_t));
+
+	if (pool == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	// Keep every buffer word aligned for the SPI DMA
+	pool->buffer_size = buffer_size;
+	pool->stride =
+		(ETHERNET_DRIVER_FRAME_POOL_HEADROOM + buffer_size + 3) & ~3UL;
+	pool->arena = heap_caps_malloc(buffer_count * pool->stride,
+								   MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+	pool->free_list = malloc(buffer_count * sizeof(uint16_t));
+
+	if (pool->arena == NULL || pool->free_list == NULL) {
+		LOGE("No memory for %" PRIu32 " frame buffers", buffer_count);
+		frame_pool_free_memory(pool);
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	for (uint32_t i = 0; i < buffer_count; i++) {
+		pool->free_list[i] = buffer_count - 1 - i;
+	}
+
+	pool->free_count     = buffer_count;
+	pool->stats.capacity = buffer_count;
+
+	portMUX_INITIALIZE(&pool->lock);
+
+	*out = pool;
+
+	return ESP_OK;
+}
+
+void ethernet_driver_frame_pool_del(ethernet_driver_frame_pool_t *pool) {
+	uint32_t in_use;
+
+	if (pool == NULL) {
+		return;
+	}
+
+	portENTER_CRITICAL_SAFE(&pool->lock);
+	pool->released = true;
+	in_use         = pool->stats.in_use;
+	portEXIT_CRITICAL_SAFE(&pool->lock);
+
+	// Otherwise freed with the last buffer lwIP returns
+	if (in_use == 0) {
+		frame_pool_free_memory(pool);
+	} else {
+		LOGW("Releasing pool with %" PRIu32 " buffer(s) in use", in_use);
+	}
+}
+
+uint8_t *ethernet_driver_frame_pool_alloc(ethernet_driver_frame_pool_t *pool) {
+	uint32_t index;
+
+	portENTER_CRITICAL_SAFE(&pool->lock);
+
+	if (pool->free_count == 0) {
+		pool->stats.exhausted++;
+		portEXIT_CRITICAL_SAFE(&pool->lock);
+
+		return NULL;
+	}
+
+	index = pool->free_list[--pool->free_count];
+
+	pool->stats.allocations++;
+	pool->stats.in_use = pool->stats.capacity - pool->free_count;
+
+	if (pool->stats.in_use > pool->stats.high_water_mark) {
+		pool->stats.high_water_mark = pool->stats.in_use;
+	}
+
+	portEXIT_CRITICAL_SAFE(&pool->lock);
+
+	return pool->arena + index * pool->stride +
+		   ETHERNET_DRIVER_FRAME_POOL_HEADROOM;
+}
+
+void ethernet_driver_frame_pool_free(ethernet_driver_frame_pool_t *pool,
+									 void                         *buffer) {
+	uint32_t index = ((uint8_t *)buffer - pool->arena -
+					  ETHERNET_DRIVER_FRAME_POOL_HEADROOM) /
+					 pool->stride;
+	bool     last;
+
+	portENTER_CRITICAL_SAFE(&pool->lock);
+
+	pool->free_list[pool->free_count++] = index;
+	pool->stats.in_use = pool->stats.capacity - pool->free_count;
+	last               = pool->released && pool->stats.in_use == 0;
+
+	portEXIT_CRITICAL_SAFE(&pool->lock);
+
+	// The driver is gone, this was the last buffer lwIP held
+	if (last) {
+		frame_pool_free_memory(pool);
+	}
+}
+
+bool ethernet_driver_frame_pool_owns(const ethernet_driver_frame_pool_t *pool,
+									 const void *buffer) {
+	const uint8_t *address = buffer;
+
+	return pool != NULL && pool->arena != NULL && address >= pool->arena &&
+		   address < pool->arena + pool->stats.capacity * pool->stride;
+}
+
+void ethernet_driver_frame_pool_get_stats(
+	ethernet_driver_frame_pool_t       *pool,
+	ethernet_driver_frame_pool_stats_t *stats) {
+	portENTER_CRITICAL_SAFE(&pool->lock);
+	*stats = pool->stats;
+	portEXIT_CRITICAL_SAFE(&pool->lock);
+}
+
+void ethernet_driver_frame_pool_reset_stats(
+	ethernet_driver_frame_pool_t *pool) {
+	portENTER_CRITICAL_SAFE(&pool->lock);
+	pool->stats.high_water_mark = pool->stats.in_use;
+	pool->stats.allocations     = 0;
+	pool->stats.exhausted       = 0;
+	portEXIT_CRITICAL_SAFE(&pool->lock);
+}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
@@ -0,0 +1,337 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_lease.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_LEASE_CACHE
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+	#include "esp_netif.h"
+	#include "nvs.h"
+
+	#include "lwip/dhcp.h"
+	#include "lwip/prot/dhcp.h"
+	#include "lwip/tcpip.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_lease.h"
+
+LOG_TAG("ethernet_driver_lease");
+
+	#define LEASE_NVS_NAMESPACE "eth_driver"
+
+typedef struct lease_interface_s {
+	esp_netif_t                  *netif;
+	ethernet_driver_lease_t       lease;
+	ethernet_driver_lease_state_t state;
+	bool                          loaded;
+	bool                          valid;
+} lease_interface_t;
+
+static lease_interface_t s_interfaces[ETHERNET_DRIVER_ETHERNETS_NUM];
+
+static void lease_key(uint32_t index, char *key, size_t size) {
+	snprintf(key, size, "lease%" PRIu32, index);
+}
+
+static esp_err_t lease_nvs_load(uint32_t index, ethernet_driver_lease_t *lease,
+								void *arg) {
+	size_t       size = sizeof(ethernet_driver_lease_t);
+	nvs_handle_t nvs;
+	char         key[16];
+
+	lease_key(index, key, sizeof(key));
+
+	esp_err_t ret = nvs_open(LEASE_NVS_NAMESPACE, NVS_READONLY, &nvs);
+
+	if (ret == ESP_OK) {
+		ret = nvs_get_blob(nvs, key, lease, &size);
+		nvs_close(nvs);
+	}
+
+	// A missing namespace or key and a record of another layout alike
+	if (ret == ESP_ERR_NVS_NOT_FOUND ||
+		(ret == ESP_OK && size != sizeof(ethernet_driver_lease_t))) {
+		ret = ESP_ERR_NOT_FOUND;
+	}
+
+	return ret;
+}
+
+static esp_err_t lease_nvs_save(uint32_t                       index,
+								const ethernet_driver_lease_t *lease,
+								void                          *arg) {
+	nvs_handle_t nvs;
+	char         key[16];
+
+	lease_key(index, key, sizeof(key));
+
+	esp_err_t ret = nvs_open(LEASE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	ret = nvs_set_blob(nvs, key, lease, sizeof(ethernet_driver_lease_t));
+
+	if (ret == ESP_OK) {
+		ret = nvs_commit(nvs);
+	}
+
+	nvs_close(nvs);
+
+	return ret;
+}
+
+static esp_err_t lease_nvs_erase(uint32_t index, void *arg) {
+	nvs_handle_t nvs;
+	char         key[16];
+
+	lease_key(index, key, sizeof(key));
+
+	esp_err_t ret = nvs_open(LEASE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	ret = nvs_erase_key(nvs, key);
+
+	if (ret == ESP_OK) {
+		ret = nvs_commit(nvs);
+	}
+
+	nvs_close(nvs);
+
+	return ret == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : ret;
+}
+
+static const ethernet_driver_lease_store_t s_nvs_store = {
+	.load  = lease_nvs_load,
+	.save  = lease_nvs_save,
+	.erase = lease_nvs_erase,
+};
+
+static ethernet_driver_lease_store_t s_store = {
+	.load  = lease_nvs_load,
+	.save  = lease_nvs_save,
+	.erase = lease_nvs_erase,
+};
+
+/**
+ * Runs in the tcpip thread right after esp-netif started DHCP. From
+ * REBOOTING lwIP requests offered_ip_addr without a DISCOVER, and goes back
+ * to DISCOVER on a NAK or once its reboot retries ran out.
+ */
+static void lease_reboot(void *arg) {
+	lease_interface_t *interface = arg;
+	struct netif      *netif     = esp_netif_get_netif_impl(interface->netif);
+	struct dhcp       *dhcp      = NULL;
+
+	if (netif != NULL) {
+		dhcp = netif_dhcp_data(netif);
+	}
+
+	// Only while the DISCOVER of dhcp_start() is unanswered
+	if (dhcp == NULL || dhcp->state != DHCP_STATE_SELECTING) {
+		interface->state = ETHERNET_DRIVER_LEASE_NONE;
+
+		return;
+	}
+
+	dhcp->offered_ip_addr.addr = interface->lease.ip;
+	dhcp->state                = DHCP_STATE_REBOOTING;
+
+	dhcp_network_changed(netif);
+}
+
+esp_err_t ethernet_driver_lease_set_store(
+	const ethernet_driver_lease_store_t *store) {
+	if (store == NULL) {
+		s_store = s_nvs_store;
+
+		return ESP_OK;
+	}
+
+	if (store->load == NULL || store->save == NULL || store->erase == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	s_store = *store;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_lease_get(uint32_t                       index,
+									ethernet_driver_lease_t       *lease,
+									ethernet_driver_lease_state_t *state) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || lease == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	if (!s_interfaces[index].valid) {
+		return ESP_ERR_NOT_FOUND;
+	}
+
+	*lease = s_interfaces[index].lease;
+
+	if (state != NULL) {
+		*state = s_interfaces[index].state;
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_lease_erase(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	s_interfaces[index].loaded = true;
+	s_interfaces[index].valid  = false;
+
+	return s_store.erase(index, s_store.arg);
+}
+
+void ethernet_driver_lease_link_up(uint32_t index, esp_netif_t *netif,
+								   esp_eth_handle_t eth_handle) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	lease_interface_t      *interface = &s_interfaces[index];
+	esp_netif_dhcp_status_t status    = ESP_NETIF_DHCP_INIT;
+	eth_speed_t             speed     = ETH_SPEED_100M;
+	eth_duplex_t            duplex    = ETH_DUPLEX_FULL;
+
+	interface->netif = netif;
+	interface->state = ETHERNET_DRIVER_LEASE_NONE;
+
+	// Later link ups reuse the lease of the previous one
+	if (!interface->loaded) {
+		interface->loaded = true;
+		interface->valid =
+			s_store.load(index, &interface->lease, s_store.arg) == ESP_OK;
+	}
+
+	if (!interface->valid || interface->lease.ip == 0 ||
+		esp_netif_dhcpc_get_status(netif, &status) != ESP_OK ||
+		status != ESP_NETIF_DHCP_STARTED) {
+		return;
+	}
+
+	esp_eth_ioctl(eth_handle, ETH_CMD_G_SPEED, &speed);
+	esp_eth_ioctl(eth_handle, ETH_CMD_G_DUPLEX_MODE, &duplex);
+
+	// Another link partner likely means another network, where the cached
+	// address would only cost the reboot retries
+	if (speed != interface->lease.speed || duplex != interface->lease.duplex) {
+		LOGI("Interface %" PRIu32 " link changed, full DHCP", index);
+
+		return;
+	}
+
+	interface->state = ETHERNET_DRIVER_LEASE_REBOOTING;
+
+	if (tcpip_callback(lease_reboot, interface) != ERR_OK) {
+		interface->state = ETHERNET_DRIVER_LEASE_NONE;
+	}
+}
+
+void ethernet_driver_lease_got_ip(uint32_t index, esp_netif_t *netif,
+								  esp_eth_handle_t           eth_handle,
+								  const esp_netif_ip_info_t *ip_info) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	lease_interface_t      *interface  = &s_interfaces[index];
+	struct netif           *lwip_netif = esp_netif_get_netif_impl(netif);
+	esp_netif_dhcp_status_t status     = ESP_NETIF_DHCP_INIT;
+	eth_speed_t             speed      = ETH_SPEED_100M;
+	eth_duplex_t            duplex     = ETH_DUPLEX_FULL;
+	esp_netif_dns_info_t    dns;
+	ethernet_driver_lease_t lease;
+
+	// Static addresses are no lease
+	if (lwip_netif == NULL || netif_dhcp_data(lwip_netif) == NULL ||
+		esp_netif_dhcpc_get_status(netif, &status) != ESP_OK ||
+		status != ESP_NETIF_DHCP_STARTED) {
+		return;
+	}
+
+	// Zeroed padding keeps records comparable
+	memset(&lease, 0, sizeof(lease));
+
+	lease.ip      = ip_info->ip.addr;
+	lease.netmask = ip_info->netmask.addr;
+	lease.gw      = ip_info->gw.addr;
+
+	for (int i = 0; i < 2; i++) {
+		if (esp_netif_get_dns_info(netif, ESP_NETIF_DNS_MAIN + i, &dns) ==
+			ESP_OK) {
+			lease.dns[i] = dns.ip.u_addr.ip4.addr;
+		}
+	}
+
+	// Set by lwIP before esp-netif posted the event
+	lease.lease_time_s = netif_dhcp_data(lwip_netif)->offered_t0_lease;
+
+	esp_eth_ioctl(eth_handle, ETH_CMD_G_SPEED, &speed);
+	esp_eth_ioctl(eth_handle, ETH_CMD_G_DUPLEX_MODE, &duplex);
+
+	lease.speed  = speed;
+	lease.duplex = duplex;
+
+	if (interface->state == ETHERNET_DRIVER_LEASE_REBOOTING) {
+		interface->state = lease.ip == interface->lease.ip
+							 ? ETHERNET_DRIVER_LEASE_REUSED
+							 : ETHERNET_DRIVER_LEASE_NEW;
+	}
+
+	// Renewals of an unchanged lease do not wear the flash
+	if (interface->valid &&
+		memcmp(&lease, &interface->lease, sizeof(lease)) == 0) {
+		return;
+	}
+
+	interface->lease  = lease;
+	interface->valid  = true;
+	interface->loaded = true;
+
+	esp_err_t ret = s_store.save(index, &lease, s_store.arg);
+
+	if (ret != ESP_OK) {
+		LOGW("Could not cache lease of interface %" PRIu32 ": %s", index,
+			 esp_err_to_name(ret));
+	}
+}
+#endif // CONFIG_ETHERNET_DRIVER_LEASE_CACHE
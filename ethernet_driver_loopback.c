@@ -0,0 +1,602 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_loopback.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/task.h"
+	#include "freertos/queue.h"
+
+	#include "esp_eth.h"
+	#include "esp_err.h"
+	#include "esp_timer.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver_loopback.h"
+
+LOG_TAG("ethernet_driver_loopback");
+
+typedef struct loopback_frame_s {
+	uint8_t *buffer;
+	uint32_t length;
+	int64_t  timestamp_us;
+} loopback_frame_t;
+
+typedef struct emac_loopback_s {
+	esp_eth_mac_t                     parent;
+	esp_eth_mediator_t               *eth;
+	struct emac_loopback_s           *peer;
+	QueueHandle_t                     rx_queue;
+	TaskHandle_t                      rx_task;
+	TaskHandle_t                      deleter; // Waits for the task to exit
+	volatile bool                     exiting;
+	ethernet_driver_loopback_probe_t *probe;
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ethernet_driver_frame_pool_t *frame_pool;
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	uint8_t addr[ETH_ADDR_LEN];
+	bool    started;
+	bool    promiscuous;
+} emac_loopback_t;
+
+typedef struct phy_loopback_s {
+	esp_eth_phy_t       parent;
+	esp_eth_mediator_t *eth;
+	uint32_t            addr;
+	eth_link_t          link;
+	eth_link_t          reported_link;
+} phy_loopback_t;
+
+/** Take a frame buffer from the pool, falling back to the heap */
+static uint8_t *emac_loopback_alloc_buffer(emac_loopback_t *emac,
+										   uint32_t         length) {
+	uint8_t *buffer = NULL;
+
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	if (emac->frame_pool != NULL) {
+		buffer = ethernet_driver_frame_pool_alloc(emac->frame_pool);
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	if (buffer == NULL) {
+		buffer = malloc(length);
+
+		if (buffer != NULL && emac->probe != NULL) {
+			emac->probe->heap_allocations++;
+		}
+	}
+
+	return buffer;
+}
+
+static void emac_loopback_free_buffer(emac_loopback_t *emac, uint8_t *buffer) {
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	if (ethernet_driver_frame_pool_owns(emac->frame_pool, buffer)) {
+		ethernet_driver_frame_pool_free(emac->frame_pool, buffer);
+
+		return;
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	free(buffer);
+}
+
+/** Hand a received frame to the mediator and feed the latency probe */
+static void emac_loopback_deliver(emac_loopback_t *emac,
+								  loopback_frame_t *frame) {
+	if (!emac->started) {
+		emac_loopback_free_buffer(emac, frame->buffer);
+		return;
+	}
+
+	// Ownership of the buffer is passed to the upper layer
+	emac->eth->stack_input(emac->eth, frame->buffer, frame->length);
+
+	ethernet_driver_loopback_probe_t *probe = emac->probe;
+
+	if (probe != NULL && probe->count < probe->capacity) {
+		int64_t now = esp_timer_get_time();
+
+		if (probe->count == 0) {
+			probe->first_rx_us = now;
+		}
+
+		probe->latency_us[probe->count] = (uint32_t)(now - frame->timestamp_us);
+		probe->last_rx_us               = now;
+		probe->count++;
+	}
+}
+
+static void emac_loopback_task(void *arg) {
+	emac_loopback_t *emac = (emac_loopback_t *)arg;
+	loopback_frame_t frame;
+
+	while (1) {
+		if (xQueueReceive(emac->rx_queue, &frame, portMAX_DELAY) != pdTRUE) {
+			continue;
+		}
+
+		// Woken by del with an empty frame, never killed mid delivery
+		if (emac->exiting) {
+			xTaskNotifyGive(emac->deleter);
+			vTaskDelete(NULL);
+		}
+
+		emac_loopback_deliver(emac, &frame);
+	}
+}
+
+static esp_err_t emac_loopback_set_mediator(esp_eth_mac_t      *mac,
+											esp_eth_mediator_t *eth) {
+	if (eth == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+	emac->eth             = eth;
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_init(esp_eth_mac_t *mac) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+
+	return emac->eth->on_state_changed(emac->eth, ETH_STATE_LLINIT, NULL);
+}
+
+static esp_err_t emac_loopback_deinit(esp_eth_mac_t *mac) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+
+	mac->stop(mac);
+
+	return emac->eth->on_state_changed(emac->eth, ETH_STATE_DEINIT, NULL);
+}
+
+static esp_err_t emac_loopback_start(esp_eth_mac_t *mac) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+	emac->started         = true;
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_stop(esp_eth_mac_t *mac) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+	emac->started         = false;
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_transmit(esp_eth_mac_t *mac, uint8_t *buf,
+										uint32_t length) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+
+	if (length > ETH_MAX_PACKET_SIZE) {
+		return ESP_ERR_INVALID_SIZE;
+	}
+
+	// The buffer belongs to the receiving side from here on
+	emac_loopback_t *peer  = emac->peer;
+	loopback_frame_t frame = {
+		.buffer       = emac_loopback_alloc_buffer(peer, length),
+		.length       = length,
+		.timestamp_us = esp_timer_get_time(),
+	};
+
+	if (frame.buffer == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	memcpy(frame.buffer, buf, length);
+
+	if (xQueueSend(peer->rx_queue, &frame, 0) != pdTRUE) {
+		emac_loopback_free_buffer(peer, frame.buffer);
+
+		return ESP_FAIL;
+	}
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_receive(esp_eth_mac_t *mac, uint8_t *buf,
+									   uint32_t *length) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+	loopback_frame_t frame;
+
+	if (xQueueReceive(emac->rx_queue, &frame, 0) != pdTRUE) {
+		*length = 0;
+
+		return ESP_OK;
+	}
+
+	if (frame.length > *length) {
+		emac_loopback_free_buffer(emac, frame.buffer);
+
+		return ESP_ERR_INVALID_SIZE;
+	}
+
+	memcpy(buf, frame.buffer, frame.length);
+	*length = frame.length;
+	emac_loopback_free_buffer(emac, frame.buffer);
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_read_phy_reg(esp_eth_mac_t *mac,
+											uint32_t phy_addr, uint32_t phy_reg,
+											uint32_t *reg_value) {
+	*reg_value = 0;
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_write_phy_reg(esp_eth_mac_t *mac,
+											 uint32_t       phy_addr,
+											 uint32_t       phy_reg,
+											 uint32_t       reg_value) {
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_set_addr(esp_eth_mac_t *mac, uint8_t *addr) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+
+	memcpy(emac->addr, addr, ETH_ADDR_LEN);
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_get_addr(esp_eth_mac_t *mac, uint8_t *addr) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+
+	memcpy(addr, emac->addr, ETH_ADDR_LEN);
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_set_speed(esp_eth_mac_t *mac,
+										 eth_speed_t    speed) {
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_set_duplex(esp_eth_mac_t *mac,
+										  eth_duplex_t   duplex) {
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_set_link(esp_eth_mac_t *mac, eth_link_t link) {
+	return link == ETH_LINK_UP ? mac->start(mac) : mac->stop(mac);
+}
+
+static esp_err_t emac_loopback_set_promiscuous(esp_eth_mac_t *mac,
+											   bool           enable) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+	emac->promiscuous     = enable;
+
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_enable_flow_ctrl(esp_eth_mac_t *mac,
+												bool           enable) {
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_set_peer_pause_ability(esp_eth_mac_t *mac,
+													  uint32_t ability) {
+	return ESP_OK;
+}
+
+static esp_err_t emac_loopback_del(esp_eth_mac_t *mac) {
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+	loopback_frame_t frame = {0};
+
+	// The peer transmits to itself from here on
+	if (emac->peer != emac) {
+		emac->peer->peer = emac->peer;
+	}
+
+	// Let the task leave its delivery, the queue is drained after it
+	emac->deleter = xTaskGetCurrentTaskHandle();
+	emac->exiting = true;
+	xQueueSendToFront(emac->rx_queue, &frame, portMAX_DELAY);
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	while (xQueueReceive(emac->rx_queue, &frame, 0) == pdTRUE) {
+		emac_loopback_free_buffer(emac, frame.buffer);
+	}
+
+	vQueueDelete(emac->rx_queue);
+
+	free(emac);
+
+	return ESP_OK;
+}
+
+
+esp_eth_mac_t *ethernet_driver_loopback_mac_new(
+	const ethernet_driver_loopback_config_t *loopback_config,
+	const eth_mac_config_t                  *mac_config) {
+	if (loopback_config == NULL || mac_config == NULL) {
+		LOGE("Invalid arguments");
+
+		return NULL;
+	}
+
+	emac_loopback_t *emac = calloc(1, sizeof(emac_loopback_t));
+
+	if (emac == NULL) {
+		LOGE("No memory for loopback MAC");
+
+		return NULL;
+	}
+
+	// Until connected to a peer, transmitted frames come back to ourselves
+	emac->peer = emac;
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	emac->frame_pool = loopback_config->frame_pool;
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	emac->parent.set_mediator           = emac_loopback_set_mediator;
+	emac->parent.init                   = emac_loopback_init;
+	emac->parent.deinit                 = emac_loopback_deinit;
+	emac->parent.start                  = emac_loopback_start;
+	emac->parent.stop                   = emac_loopback_stop;
+	emac->parent.transmit               = emac_loopback_transmit;
+	emac->parent.receive                = emac_loopback_receive;
+	emac->parent.read_phy_reg           = emac_loopback_read_phy_reg;
+	emac->parent.write_phy_reg          = emac_loopback_write_phy_reg;
+	emac->parent.set_addr               = emac_loopback_set_addr;
+	emac->parent.get_addr               = emac_loopback_get_addr;
+	emac->parent.set_speed              = emac_loopback_set_speed;
+	emac->parent.set_duplex             = emac_loopback_set_duplex;
+	emac->parent.set_link               = emac_loopback_set_link;
+	emac->parent.set_promiscuous        = emac_loopback_set_promiscuous;
+	emac->parent.enable_flow_ctrl       = emac_loopback_enable_flow_ctrl;
+	emac->parent.set_peer_pause_ability = emac_loopback_set_peer_pause_ability;
+	emac->parent.del                    = emac_loopback_del;
+
+	emac->rx_queue =
+		xQueueCreate(loopback_config->rx_queue_len, sizeof(loopback_frame_t));
+
+	if (emac->rx_queue == NULL) {
+		LOGE("No memory for loopback RX queue");
+		free(emac);
+
+		return NULL;
+	}
+
+
+	BaseType_t core_num = tskNO_AFFINITY;
+
+	if (mac_config->flags & ETH_MAC_FLAG_PIN_TO_CORE) {
+		core_num = xPortGetCoreID();
+	}
+
+	if (xTaskCreatePinnedToCore(emac_loopback_task, "loopback_tsk",
+								mac_config->rx_task_stack_size, emac,
+								mac_config->rx_task_prio, &emac->rx_task,
+								core_num) != pdPASS) {
+		LOGE("Failed to create loopback RX task");
+		vQueueDelete(emac->rx_queue);
+		free(emac);
+
+		return NULL;
+	}
+
+	return &emac->parent;
+}
+
+esp_err_t ethernet_driver_loopback_connect(esp_eth_mac_t *mac_a,
+										   esp_eth_mac_t *mac_b) {
+	if (mac_a == NULL || mac_b == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	emac_loopback_t *emac_a = __containerof(mac_a, emac_loopback_t, parent);
+	emac_loopback_t *emac_b = __containerof(mac_b, emac_loopback_t, parent);
+
+	emac_a->peer = emac_b;
+	emac_b->peer = emac_a;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_loopback_set_probe(
+	esp_eth_mac_t *mac, ethernet_driver_loopback_probe_t *probe) {
+	if (mac == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	emac_loopback_t *emac = __containerof(mac, emac_loopback_t, parent);
+
+	if (probe != NULL) {
+		probe->count            = 0;
+		probe->heap_allocations = 0;
+		probe->first_rx_us      = 0;
+		probe->last_rx_us       = 0;
+	}
+
+	emac->probe = probe;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_set_mediator(esp_eth_phy_t      *phy,
+										   esp_eth_mediator_t *eth) {
+	if (eth == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	phy_loopback_t *loopback = __containerof(phy, phy_loopback_t, parent);
+	loopback->eth            = eth;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_reset(esp_eth_phy_t *phy) {
+	phy_loopback_t *loopback = __containerof(phy, phy_loopback_t, parent);
+	loopback->reported_link  = ETH_LINK_DOWN;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_reset_hw(esp_eth_phy_t *phy) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_init(esp_eth_phy_t *phy) {
+	return phy->reset(phy);
+}
+
+static esp_err_t phy_loopback_deinit(esp_eth_phy_t *phy) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_autonego_ctrl(esp_eth_phy_t        *phy,
+											eth_phy_autoneg_cmd_t cmd,
+											bool *autonego_en_stat) {
+	*autonego_en_stat = cmd != ESP_ETH_PHY_AUTONEGO_DIS;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_get_link(esp_eth_phy_t *phy) {
+	phy_loopback_t     *loopback = __containerof(phy, phy_loopback_t, parent);
+	esp_eth_mediator_t *eth      = loopback->eth;
+
+	if (loopback->reported_link == loopback->link) {
+		return ESP_OK;
+	}
+
+	if (loopback->link == ETH_LINK_UP) {
+		eth->on_state_changed(eth, ETH_STATE_SPEED, (void *)ETH_SPEED_100M);
+		eth->on_state_changed(eth, ETH_STATE_DUPLEX, (void *)ETH_DUPLEX_FULL);
+		eth->on_state_changed(eth, ETH_STATE_PAUSE, (void *)0);
+	}
+
+	loopback->reported_link = loopback->link;
+
+	return eth->on_state_changed(eth, ETH_STATE_LINK, (void *)loopback->link);
+}
+
+static esp_err_t phy_loopback_pwrctl(esp_eth_phy_t *phy, bool enable) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_set_addr(esp_eth_phy_t *phy, uint32_t addr) {
+	phy_loopback_t *loopback = __containerof(phy, phy_loopback_t, parent);
+	loopback->addr           = addr;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_get_addr(esp_eth_phy_t *phy, uint32_t *addr) {
+	phy_loopback_t *loopback = __containerof(phy, phy_loopback_t, parent);
+	*addr                    = loopback->addr;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_advertise_pause_ability(esp_eth_phy_t *phy,
+													  uint32_t ability) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_loopback(esp_eth_phy_t *phy, bool enable) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_set_speed(esp_eth_phy_t *phy,
+										eth_speed_t    speed) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_set_duplex(esp_eth_phy_t *phy,
+										 eth_duplex_t   duplex) {
+	return ESP_OK;
+}
+
+static esp_err_t phy_loopback_del(esp_eth_phy_t *phy) {
+	phy_loopback_t *loopback = __containerof(phy, phy_loopback_t, parent);
+
+	free(loopback);
+
+	return ESP_OK;
+}
+
+esp_eth_phy_t *ethernet_driver_loopback_phy_new(
+	const eth_phy_config_t *phy_config) {
+	if (phy_config == NULL) {
+		LOGE("Invalid arguments");
+
+		return NULL;
+	}
+
+	phy_loopback_t *loopback = calloc(1, sizeof(phy_loopback_t));
+
+	if (loopback == NULL) {
+		LOGE("No memory for loopback PHY");
+
+		return NULL;
+	}
+
+	loopback->addr                           = phy_config->phy_addr;
+	loopback->link                           = ETH_LINK_UP;
+	loopback->reported_link                  = ETH_LINK_DOWN;
+	loopback->parent.set_mediator            = phy_loopback_set_mediator;
+	loopback->parent.reset                   = phy_loopback_reset;
+	loopback->parent.reset_hw                = phy_loopback_reset_hw;
+	loopback->parent.init                    = phy_loopback_init;
+	loopback->parent.deinit                  = phy_loopback_deinit;
+	loopback->parent.autonego_ctrl           = phy_loopback_autonego_ctrl;
+	loopback->parent.get_link                = phy_loopback_get_link;
+	loopback->parent.pwrctl                  = phy_loopback_pwrctl;
+	loopback->parent.set_addr                = phy_loopback_set_addr;
+	loopback->parent.get_addr                = phy_loopback_get_addr;
+	loopback->parent.advertise_pause_ability =
+		phy_loopback_advertise_pause_ability;
+	loopback->parent.loopback                = phy_loopback_loopback;
+	loopback->parent.set_speed               = phy_loopback_set_speed;
+	loopback->parent.set_duplex              = phy_loopback_set_duplex;
+	loopback->parent.del                     = phy_loopback_del;
+
+	return &loopback->parent;
+}
+
+esp_err_t ethernet_driver_loopback_phy_set_link(esp_eth_phy_t *phy,
+												eth_link_t     link) {
+	if (phy == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	phy_loopback_t *loopback = __containerof(phy, phy_loopback_t, parent);
+	loopback->link           = link;
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
@@ -0,0 +1,966 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_mac_filter.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/semphr.h"
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+	#include "esp_idf_version.h"
+	#include "esp_netif.h"
+	#include "esp_rom_crc.h"
+	#include "esp_timer.h"
+
+	#include "lwip/igmp.h"
+	#include "lwip/mld6.h"
+	#include "lwip/netif.h"
+	#include "lwip/tcpip.h"
+
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051 || CONFIG_ETHERNET_DRIVER_USE_W5500
+		#include "driver/spi_master.h"
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051 || USE_W5500
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_mac_filter.h"
+
+LOG_TAG("ethernet_driver_mac_filter");
+
+	#define MAC_FILTER_GROUPS        CONFIG_ETHERNET_DRIVER_MAC_FILTER_GROUPS
+	#define MAC_FILTER_LOCK_TIMEOUT  pdMS_TO_TICKS(50)
+
+	#define DM9051_SPI_READ          0
+	#define DM9051_SPI_WRITE         1
+	#define DM9051_RCR               0x05
+	#define DM9051_RCR_ALL           (1 << 3)
+	#define DM9051_MAR               0x16
+
+	#define W5500_BSB_SOCK0_REG      0x01
+	#define W5500_CONTROL_WRITE      (1 << 2)
+	#define W5500_SN_MR              0x0000
+	#define W5500_SN_MR_MFEN         (1 << 7)
+	#define W5500_SN_MR_BCASTB       (1 << 6)
+	#define W5500_SN_MR_MMB          (1 << 5)
+
+	#define KSZ8851_RXCR1            0x74
+	#define KSZ8851_RXCR1_RXINVF     (1 << 1)
+	#define KSZ8851_RXCR1_RXAE       (1 << 4)
+	#define KSZ8851_RXCR1_RXME       (1 << 6)
+	#define KSZ8851_RXCR1_RXBE       (1 << 7)
+	#define KSZ8851_RXCR1_RXMAFMA    (1 << 8)
+	#define KSZ8851_RXCR1_RXPAFMA    (1 << 11)
+	#define KSZ8851_RXCR1_FILTER                                            \
+		(KSZ8851_RXCR1_RXINVF | KSZ8851_RXCR1_RXAE | KSZ8851_RXCR1_RXME | \
+		 KSZ8851_RXCR1_RXBE | KSZ8851_RXCR1_RXMAFMA | KSZ8851_RXCR1_RXPAFMA)
+	#define KSZ8851_MAHTR0           0xA0
+
+	#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+		// The MAC drivers program their filters through esp_eth_ioctl()
+		#define MAC_FILTER_ETH_CMD 1
+	#endif // ESP_IDF_VERSION >= 5.3
+
+	#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && !MAC_FILTER_ETH_CMD
+		#include "soc/emac_mac_struct.h"
+
+		#define MAC_FILTER_EMAC 1
+	#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET && !ETH_CMD
+
+	#if (CONFIG_ETHERNET_DRIVER_USE_DM9051 || \
+		 CONFIG_ETHERNET_DRIVER_USE_W5500) &&  \
+		ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 1, 0)
+		#define MAC_FILTER_SPI_MAC 1
+
+/**
+ * Head shared by the DM9051 and W5500 MAC drivers of ESP-IDF 5.0. They
+ * keep their register accessors private, the filter registers are written
+ * on their SPI device under their own lock.
+ */
+typedef struct mac_filter_spi_mac_s {
+	esp_eth_mac_t       parent;
+	esp_eth_mediator_t *eth;
+	spi_device_handle_t spi_hdl;
+	SemaphoreHandle_t   spi_lock;
+} mac_filter_spi_mac_t;
+	#endif // USE_DM9051 || USE_W5500 && ESP_IDF_VERSION < 5.1
+
+/**
+ * How a chip filters destination addresses. hash_bit is NULL when the chip
+ * has no multicast hash table, program writes the filter registers.
+ */
+struct ethernet_driver_mac_filter_chip_s {
+	uint32_t (*hash_bit)(const uint8_t *mac);
+	esp_err_t (*program)(esp_eth_mac_t                             *mac,
+						 const ethernet_driver_mac_filter_config_t *config,
+						 const uint32_t hash[2], bool groups);
+};
+
+// Who asked for a group, each keeps its own count
+typedef enum mac_filter_source_e {
+	MAC_FILTER_SOURCE_USER,
+	MAC_FILTER_SOURCE_STACK,
+	MAC_FILTER_SOURCE_MAX,
+} mac_filter_source_t;
+
+typedef struct mac_filter_group_s {
+	uint8_t  mac[6];
+	uint16_t refs[MAC_FILTER_SOURCE_MAX];
+	#if MAC_FILTER_ETH_CMD
+	bool programmed; // Added to the driver, kept until it is deleted there
+	#endif // MAC_FILTER_ETH_CMD
+} mac_filter_group_t;
+
+typedef struct mac_filter_interface_s {
+	esp_netif_t                             *netif;
+	esp_eth_handle_t                         eth_handle;
+	esp_eth_mac_t                           *mac;
+	const ethernet_driver_mac_filter_chip_t *chip;
+	// Keeps the chip registers in the order the changes were made
+	SemaphoreHandle_t                   program_lock;
+	ethernet_driver_mac_filter_config_t config;
+	bool                                enabled;
+	uint32_t                            hash[2];
+	mac_filter_group_t                  groups[MAC_FILTER_GROUPS];
+	// Unwanted frames the driver read, apart for an open and a closed filter
+	bool     closed;
+	int64_t  since_us;
+	uint64_t open_us;
+	uint64_t closed_us;
+	uint64_t open_bytes;
+	uint64_t leaked_bytes;
+	uint32_t unwanted_frames;
+	uint32_t unwanted_bytes;
+} mac_filter_interface_t;
+
+static mac_filter_interface_t s_interfaces[ETHERNET_DRIVER_ETHERNETS_NUM];
+static portMUX_TYPE           s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051 || \
+		CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+// Low 6 bits of the Ethernet CRC-32 before its final inversion
+static uint32_t mac_filter_crc_bits(const uint8_t *mac) {
+	return ~esp_rom_crc32_le(0, mac, 6) & 0x3F;
+}
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051 || USE_KSZ8851SNL
+
+	#if MAC_FILTER_SPI_MAC
+static esp_err_t mac_filter_spi_lock(mac_filter_spi_mac_t *spi_mac) {
+	if (xSemaphoreTake(spi_mac->spi_lock, MAC_FILTER_LOCK_TIMEOUT) != pdTRUE) {
+		return ESP_ERR_TIMEOUT;
+	}
+
+	return ESP_OK;
+}
+	#endif // MAC_FILTER_SPI_MAC
+
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051
+		#if MAC_FILTER_SPI_MAC
+static esp_err_t dm9051_read_reg(spi_device_handle_t device, uint8_t reg,
+								 uint8_t *value) {
+	spi_transaction_t trans = {
+		.flags  = SPI_TRANS_USE_RXDATA,
+		.cmd    = DM9051_SPI_READ,
+		.addr   = reg,
+		.length = 8,
+	};
+	esp_err_t ret = spi_device_polling_transmit(device, &trans);
+
+	*value = trans.rx_data[0];
+
+	return ret;
+}
+
+static esp_err_t dm9051_write_reg(spi_device_handle_t device, uint8_t reg,
+								  uint8_t value) {
+	spi_transaction_t trans = {
+		.flags   = SPI_TRANS_USE_TXDATA,
+		.cmd     = DM9051_SPI_WRITE,
+		.addr    = reg,
+		.length  = 8,
+		.tx_data = {value},
+	};
+
+	return spi_device_polling_transmit(device, &trans);
+}
+		#endif // MAC_FILTER_SPI_MAC
+
+/**
+ * Broadcast is bit 63 of the MAR hash table, which the driver sets at
+ * init. RCR ALL passes every multicast.
+ */
+static esp_err_t dm9051_program(
+	esp_eth_mac_t *mac, const ethernet_driver_mac_filter_config_t *config,
+	const uint32_t hash[2], bool groups) {
+		#if MAC_FILTER_SPI_MAC
+	mac_filter_spi_mac_t *spi_mac  = (mac_filter_spi_mac_t *)mac;
+	uint32_t              table[2] = {hash[0], hash[1]};
+	uint8_t               rcr      = 0;
+	esp_err_t             ret      = mac_filter_spi_lock(spi_mac);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	if (config->broadcast) {
+		table[1] |= 1U << 31;
+	}
+
+	for (int i = 0; ret == ESP_OK && i < 8; i++) {
+		ret = dm9051_write_reg(spi_mac->spi_hdl, DM9051_MAR + i,
+							   table[i >> 2] >> ((i & 3) * 8));
+	}
+
+	if (ret == ESP_OK) {
+		ret = dm9051_read_reg(spi_mac->spi_hdl, DM9051_RCR, &rcr);
+	}
+
+	if (ret == ESP_OK) {
+		rcr = config->all_multicast ? rcr | DM9051_RCR_ALL
+									: rcr & ~DM9051_RCR_ALL;
+		ret = dm9051_write_reg(spi_mac->spi_hdl, DM9051_RCR, rcr);
+	}
+
+	xSemaphoreGive(spi_mac->spi_lock);
+
+	return ret;
+		#else
+	return ESP_ERR_NOT_SUPPORTED;
+		#endif // MAC_FILTER_SPI_MAC
+}
+
+const ethernet_driver_mac_filter_chip_t ethernet_driver_mac_filter_dm9051 = {
+	.hash_bit = mac_filter_crc_bits,
+	.program  = dm9051_program,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051
+
+	#if CONFIG_ETHERNET_DRIVER_USE_W5500
+		#if MAC_FILTER_SPI_MAC
+// Address in the command phase, block select and R/W in the address phase
+static esp_err_t w5500_access(spi_device_handle_t device, uint16_t address,
+							  uint8_t block, uint8_t control, uint8_t *value) {
+	spi_transaction_t trans = {
+		.cmd    = address,
+		.addr   = (block << 3) | control,
+		.length = 8,
+	};
+
+	if (control & W5500_CONTROL_WRITE) {
+		trans.tx_buffer = value;
+	} else {
+		trans.rx_buffer = value;
+	}
+
+	return spi_device_polling_transmit(device, &trans);
+}
+		#endif // MAC_FILTER_SPI_MAC
+
+/**
+ * Socket 0 runs in MACRAW mode, its mode register blocks broadcast and
+ * multicast. There is no table of groups, every multicast passes once one
+ * is joined.
+ */
+static esp_err_t w5500_program(
+	esp_eth_mac_t *mac, const ethernet_driver_mac_filter_config_t *config,
+	const uint32_t hash[2], bool groups) {
+		#if MAC_FILTER_SPI_MAC
+	mac_filter_spi_mac_t *spi_mac = (mac_filter_spi_mac_t *)mac;
+	uint8_t               mode    = 0;
+	esp_err_t             ret     = mac_filter_spi_lock(spi_mac);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	ret = w5500_access(spi_mac->spi_hdl, W5500_SN_MR, W5500_BSB_SOCK0_REG, 0,
+					   &mode);
+
+	if (ret == ESP_OK) {
+		mode &= ~(W5500_SN_MR_BCASTB | W5500_SN_MR_MMB);
+		mode |= W5500_SN_MR_MFEN;
+
+		if (!config->broadcast) {
+			mode |= W5500_SN_MR_BCASTB;
+		}
+
+		if (!config->all_multicast && !groups) {
+			mode |= W5500_SN_MR_MMB;
+		}
+
+		ret = w5500_access(spi_mac->spi_hdl, W5500_SN_MR, W5500_BSB_SOCK0_REG,
+						   W5500_CONTROL_WRITE, &mode);
+	}
+
+	xSemaphoreGive(spi_mac->spi_lock);
+
+	return ret;
+		#else
+	return ESP_ERR_NOT_SUPPORTED;
+		#endif // MAC_FILTER_SPI_MAC
+}
+
+const ethernet_driver_mac_filter_chip_t ethernet_driver_mac_filter_w5500 = {
+	.hash_bit = NULL,
+	.program  = w5500_program,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+
+	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+// The chip indexes its table with the top 6 bits of the big endian CRC
+static uint32_t ksz8851_hash_bit(const uint8_t *mac) {
+	uint32_t bits = mac_filter_crc_bits(mac);
+	uint32_t bit  = 0;
+
+	for (int i = 0; i < 6; i++) {
+		bit |= ((bits >> i) & 1) << (5 - i);
+	}
+
+	return bit;
+}
+
+/**
+ * The MAC maps its PHY register accessors onto the chip registers under
+ * its SPI lock. RXCR1 is set as the Linux ks8851 driver does, MAHTR0-3
+ * hold the hash table.
+ */
+static esp_err_t ksz8851_program(
+	esp_eth_mac_t *mac, const ethernet_driver_mac_filter_config_t *config,
+	const uint32_t hash[2], bool groups) {
+	uint32_t  rxcr1 = 0;
+	esp_err_t ret   = ESP_OK;
+
+	for (int i = 0; ret == ESP_OK && i < 4; i++) {
+		ret = mac->write_phy_reg(mac, 0, KSZ8851_MAHTR0 + i * 2,
+								 (hash[i >> 1] >> ((i & 1) * 16)) & 0xFFFF);
+	}
+
+	if (ret == ESP_OK) {
+		ret = mac->read_phy_reg(mac, 0, KSZ8851_RXCR1, &rxcr1);
+	}
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	rxcr1 &= ~KSZ8851_RXCR1_FILTER;
+
+	if (config->all_multicast) {
+		rxcr1 |= KSZ8851_RXCR1_RXME | KSZ8851_RXCR1_RXAE |
+				 KSZ8851_RXCR1_RXPAFMA | KSZ8851_RXCR1_RXMAFMA;
+	} else if (groups) {
+		rxcr1 |= KSZ8851_RXCR1_RXME | KSZ8851_RXCR1_RXPAFMA;
+	} else {
+		rxcr1 |= KSZ8851_RXCR1_RXPAFMA;
+	}
+
+	if (config->broadcast) {
+		rxcr1 |= KSZ8851_RXCR1_RXBE;
+	}
+
+	return mac->write_phy_reg(mac, 0, KSZ8851_RXCR1, rxcr1);
+}
+
+const ethernet_driver_mac_filter_chip_t ethernet_driver_mac_filter_ksz8851 = {
+	.hash_bit = ksz8851_hash_bit,
+	.program  = ksz8851_program,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+
+	#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+/**
+ * The frame filter of the EMAC has no multicast hash table, like the W5500
+ * every multicast passes once a group is added. The driver passes them all
+ * after init and only switches the promiscuous bit afterwards.
+ */
+static esp_err_t esp32_program(
+	esp_eth_mac_t *mac, const ethernet_driver_mac_filter_config_t *config,
+	const uint32_t hash[2], bool groups) {
+		#if MAC_FILTER_EMAC
+	EMAC_MAC.gmacff.pam = config->all_multicast || groups;
+	EMAC_MAC.gmacff.dbf = !config->broadcast;
+
+	return ESP_OK;
+		#else
+	return ESP_ERR_NOT_SUPPORTED;
+		#endif // MAC_FILTER_EMAC
+}
+
+const ethernet_driver_mac_filter_chip_t ethernet_driver_mac_filter_esp32 = {
+	.hash_bit = NULL,
+	.program  = esp32_program,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+
+static bool mac_filter_group_used(const mac_filter_group_t *group) {
+	return group->refs[MAC_FILTER_SOURCE_USER] != 0 ||
+		   group->refs[MAC_FILTER_SOURCE_STACK] != 0;
+}
+
+// A slot takes a new address once the driver let go of the old one
+static bool mac_filter_group_free(const mac_filter_group_t *group) {
+	#if MAC_FILTER_ETH_CMD
+	if (group->programmed) {
+		return false;
+	}
+	#endif // MAC_FILTER_ETH_CMD
+
+	return !mac_filter_group_used(group);
+}
+
+static bool mac_filter_supported(
+	const mac_filter_interface_t              *interface,
+	const ethernet_driver_mac_filter_config_t *config) {
+	if (config->promiscuous || (config->broadcast && config->all_multicast)) {
+		return true;
+	}
+
+	#if MAC_FILTER_ETH_CMD
+	// The drivers filter multicast, broadcast always passes
+	return config->broadcast;
+	#else
+	return interface->chip != NULL;
+	#endif // MAC_FILTER_ETH_CMD
+}
+
+// Adds the time since the last change to the open or closed time, s_lock held
+static void mac_filter_set_closed(mac_filter_interface_t *interface,
+								  bool                    closed) {
+	int64_t now = esp_timer_get_time();
+
+	if (interface->since_us != 0 && interface->closed) {
+		interface->closed_us += now - interface->since_us;
+	} else if (interface->since_us != 0) {
+		interface->open_us += now - interface->since_us;
+	}
+
+	interface->since_us = now;
+	interface->closed   = closed;
+}
+
+// Called with s_lock held
+static mac_filter_group_t *mac_filter_find(mac_filter_interface_t *interface,
+										   const uint8_t          *mac) {
+	for (int i = 0; i < MAC_FILTER_GROUPS; i++) {
+		if (mac_filter_group_used(&interface->groups[i]) &&
+			memcmp(interface->groups[i].mac, mac, 6) == 0) {
+			return &interface->groups[i];
+		}
+	}
+
+	return NULL;
+}
+
+	#if MAC_FILTER_ETH_CMD
+/**
+ * Add the new groups to the driver and delete the released ones. A group
+ * is marked before the driver is called, so its slot is not reused while
+ * the address is still there.
+ */
+static esp_err_t mac_filter_sync_groups(mac_filter_interface_t *interface) {
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; ret == ESP_OK && i < MAC_FILTER_GROUPS; i++) {
+		mac_filter_group_t *group = &interface->groups[i];
+		uint8_t             mac[6];
+
+		portENTER_CRITICAL(&s_lock);
+
+		bool used    = mac_filter_group_used(group);
+		bool changed = used != group->programmed;
+
+		group->programmed = used;
+		memcpy(mac, group->mac, 6);
+
+		portEXIT_CRITICAL(&s_lock);
+
+		if (!changed) {
+			continue;
+		}
+
+		ret = esp_eth_ioctl(interface->eth_handle,
+							used ? ETH_CMD_ADD_MAC_FILTER
+								 : ETH_CMD_DEL_MAC_FILTER,
+							mac);
+
+		if (ret != ESP_OK && used) {
+			portENTER_CRITICAL(&s_lock);
+			group->programmed = false;
+			portEXIT_CRITICAL(&s_lock);
+		}
+	}
+
+	return ret;
+}
+
+/** All-multicast and the groups through the driver */
+static esp_err_t mac_filter_program(
+	mac_filter_interface_t              *interface,
+	ethernet_driver_mac_filter_config_t *config) {
+	esp_err_t ret = ESP_OK;
+
+	if (!config->promiscuous) {
+		ret = esp_eth_ioctl(interface->eth_handle, ETH_CMD_S_ALL_MULTICAST,
+							&config->all_multicast);
+	}
+
+	if (ret == ESP_OK) {
+		ret = mac_filter_sync_groups(interface);
+	}
+
+	return ret;
+}
+	#else
+/** The filter registers of the chip, left alone in promiscuous mode */
+static esp_err_t mac_filter_program(
+	mac_filter_interface_t              *interface,
+	ethernet_driver_mac_filter_config_t *config) {
+	uint32_t hash[2];
+	bool     groups = false;
+
+	if (config->promiscuous || interface->chip == NULL) {
+		return ESP_OK;
+	}
+
+	portENTER_CRITICAL(&s_lock);
+
+	hash[0] = interface->hash[0];
+	hash[1] = interface->hash[1];
+
+	for (int i = 0; i < MAC_FILTER_GROUPS && !groups; i++) {
+		groups = mac_filter_group_used(&interface->groups[i]);
+	}
+
+	portEXIT_CRITICAL(&s_lock);
+
+	return interface->chip->program(interface->mac, config, hash, groups);
+}
+	#endif // MAC_FILTER_ETH_CMD
+
+/**
+ * Promiscuous mode through the driver, the groups and all-multicast through
+ * the driver as well from ESP-IDF 5.3, the chip filter registers before.
+ * Interfaces without a chip filter only switch promiscuous mode there.
+ */
+static esp_err_t mac_filter_apply(mac_filter_interface_t *interface) {
+	ethernet_driver_mac_filter_config_t config;
+	bool                                closed;
+	esp_err_t                           ret;
+
+	if (interface->eth_handle == NULL || !interface->enabled) {
+		return ESP_OK;
+	}
+
+	if (interface->program_lock != NULL &&
+		xSemaphoreTake(interface->program_lock, portMAX_DELAY) != pdTRUE) {
+		return ESP_ERR_TIMEOUT;
+	}
+
+	portENTER_CRITICAL(&s_lock);
+	config = interface->config;
+	portEXIT_CRITICAL(&s_lock);
+
+	ret = esp_eth_ioctl(interface->eth_handle, ETH_CMD_S_PROMISCUOUS,
+						&config.promiscuous);
+
+	if (ret == ESP_OK) {
+		ret = mac_filter_program(interface, &config);
+	}
+
+	#if MAC_FILTER_ETH_CMD
+	closed = !config.promiscuous;
+	#else
+	closed = !config.promiscuous && interface->chip != NULL;
+	#endif // MAC_FILTER_ETH_CMD
+
+	portENTER_CRITICAL(&s_lock);
+	mac_filter_set_closed(interface, ret == ESP_OK && closed);
+	portEXIT_CRITICAL(&s_lock);
+
+	if (interface->program_lock != NULL) {
+		xSemaphoreGive(interface->program_lock);
+	}
+
+	return ret;
+}
+
+static esp_err_t mac_filter_update(uint32_t index, const uint8_t *mac,
+								   mac_filter_source_t source, bool add) {
+	mac_filter_interface_t *interface = &s_interfaces[index];
+	esp_err_t               ret       = ESP_OK;
+	#if MAC_FILTER_ETH_CMD
+	bool hashed = false;
+	#else
+	bool hashed = interface->chip != NULL && interface->chip->hash_bit != NULL;
+	#endif // MAC_FILTER_ETH_CMD
+
+	portENTER_CRITICAL(&s_lock);
+
+	mac_filter_group_t *group = mac_filter_find(interface, mac);
+
+	if (add && group == NULL) {
+		for (int i = 0; i < MAC_FILTER_GROUPS && group == NULL; i++) {
+			if (mac_filter_group_free(&interface->groups[i])) {
+				group = &interface->groups[i];
+				memcpy(group->mac, mac, 6);
+			}
+		}
+	}
+
+	if (group == NULL) {
+		ret = add ? ESP_ERR_NO_MEM : ESP_ERR_NOT_FOUND;
+	} else if (add) {
+		group->refs[source]++;
+	} else if (group->refs[source] == 0) {
+		ret = ESP_ERR_NOT_FOUND;
+	} else {
+		group->refs[source]--;
+	}
+
+	// Rebuilt rather than cleared bit by bit, groups may share a bit
+	interface->hash[0] = 0;
+	interface->hash[1] = 0;
+
+	for (int i = 0; hashed && i < MAC_FILTER_GROUPS; i++) {
+		if (mac_filter_group_used(&interface->groups[i])) {
+			uint32_t bit = interface->chip->hash_bit(interface->groups[i].mac);
+
+			interface->hash[bit >> 5] |= 1U << (bit & 31);
+		}
+	}
+
+	portEXIT_CRITICAL(&s_lock);
+
+	if (ret == ESP_OK && mac_filter_apply(interface) != ESP_OK) {
+		LOGW("Could not program the filter of interface %" PRIu32, index);
+	}
+
+	return ret;
+}
+
+static uint32_t mac_filter_index(struct netif *netif) {
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_interfaces[i].netif != NULL &&
+			esp_netif_get_netif_impl(s_interfaces[i].netif) == netif) {
+			return i;
+		}
+	}
+
+	return ETHERNET_DRIVER_ETHERNETS_NUM;
+}
+
+static err_t mac_filter_stack_update(struct netif *netif, const uint8_t *mac,
+									 enum netif_mac_filter_action action) {
+	uint32_t index = mac_filter_index(netif);
+
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return ERR_IF;
+	}
+
+	esp_err_t ret = mac_filter_update(index, mac, MAC_FILTER_SOURCE_STACK,
+									  action == NETIF_ADD_MAC_FILTER);
+
+	if (ret == ESP_ERR_NO_MEM) {
+		LOGW("No room for multicast group of interface %" PRIu32, index);
+	}
+
+	return ret == ESP_OK ? ERR_OK : ERR_MEM;
+}
+
+	#if LWIP_IGMP
+// 01:00:5E and the low 23 bits of the group
+static err_t mac_filter_igmp(struct netif *netif, const ip4_addr_t *group,
+							 enum netif_mac_filter_action action) {
+	const uint8_t *address = (const uint8_t *)&group->addr;
+	uint8_t        mac[6]  = {0x01, 0x00, 0x5E};
+
+	mac[3] = address[1] & 0x7F;
+	mac[4] = address[2];
+	mac[5] = address[3];
+
+	return mac_filter_stack_update(netif, mac, action);
+}
+	#endif // LWIP_IGMP
+
+	#if LWIP_IPV6 && LWIP_IPV6_MLD
+// 33:33 and the low 32 bits of the group
+static err_t mac_filter_mld(struct netif *netif, const ip6_addr_t *group,
+							enum netif_mac_filter_action action) {
+	const uint8_t *address = (const uint8_t *)&group->addr[3];
+	uint8_t        mac[6]  = {0x33, 0x33};
+
+	memcpy(mac + 2, address, 4);
+
+	return mac_filter_stack_update(netif, mac, action);
+}
+	#endif // LWIP_IPV6 && LWIP_IPV6_MLD
+
+/**
+ * Runs in the tcpip thread once the netif was added, which cleared its
+ * filter callbacks. The groups joined by then are replayed, lwIP removes
+ * all of them through the callbacks when the netif is removed.
+ */
+static void mac_filter_install(void *arg) {
+	mac_filter_interface_t *interface = arg;
+	struct netif           *netif = esp_netif_get_netif_impl(interface->netif);
+
+	if (netif == NULL) {
+		return;
+	}
+
+	#if LWIP_IGMP
+	netif_set_igmp_mac_filter(netif, mac_filter_igmp);
+
+	for (struct igmp_group *group = netif_igmp_data(netif); group != NULL;
+		 group = group->next) {
+		mac_filter_igmp(netif, &group->group_address, NETIF_ADD_MAC_FILTER);
+	}
+	#endif // LWIP_IGMP
+
+	#if LWIP_IPV6 && LWIP_IPV6_MLD
+	netif_set_mld_mac_filter(netif, mac_filter_mld);
+
+	for (struct mld_group *group = netif_mld6_data(netif); group != NULL;
+		 group = group->next) {
+		mac_filter_mld(netif, &group->group_address, NETIF_ADD_MAC_FILTER);
+	}
+	#endif // LWIP_IPV6 && LWIP_IPV6_MLD
+}
+
+esp_err_t ethernet_driver_mac_filter_set(
+	uint32_t index, const ethernet_driver_mac_filter_config_t *config) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || config == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	mac_filter_interface_t *interface = &s_interfaces[index];
+
+	if (!mac_filter_supported(interface, config)) {
+		return ESP_ERR_NOT_SUPPORTED;
+	}
+
+	portENTER_CRITICAL(&s_lock);
+
+	interface->config  = *config;
+	interface->enabled = true;
+
+	portEXIT_CRITICAL(&s_lock);
+
+	// Applied when the interface starts otherwise
+	return mac_filter_apply(interface);
+}
+
+esp_err_t ethernet_driver_mac_filter_add(uint32_t index, const uint8_t *mac) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || mac == NULL ||
+		(mac[0] & 0x01) == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	return mac_filter_update(index, mac, MAC_FILTER_SOURCE_USER, true);
+}
+
+esp_err_t ethernet_driver_mac_filter_del(uint32_t index, const uint8_t *mac) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || mac == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	return mac_filter_update(index, mac, MAC_FILTER_SOURCE_USER, false);
+}
+
+esp_err_t ethernet_driver_mac_filter_get_stats(
+	uint32_t index, ethernet_driver_mac_filter_stats_t *stats) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	mac_filter_interface_t *interface = &s_interfaces[index];
+	ethernet_driver_stats_t driver_stats;
+	uint64_t                open_us;
+	uint64_t                closed_us;
+	uint64_t                open_bytes;
+	uint64_t                leaked_bytes;
+	int64_t                 now = esp_timer_get_time();
+
+	memset(stats, 0, sizeof(ethernet_driver_mac_filter_stats_t));
+
+	portENTER_CRITICAL(&s_lock);
+
+	for (int i = 0; i < MAC_FILTER_GROUPS; i++) {
+		if (mac_filter_group_used(&interface->groups[i])) {
+			stats->groups++;
+		}
+	}
+
+	stats->multicast_hash[0] = interface->hash[0];
+	stats->multicast_hash[1] = interface->hash[1];
+	stats->unwanted_frames   = interface->unwanted_frames;
+	stats->unwanted_bytes    = interface->unwanted_bytes;
+
+	open_us      = interface->open_us;
+	closed_us    = interface->closed_us;
+	open_bytes   = interface->open_bytes;
+	leaked_bytes = interface->leaked_bytes;
+
+	// The current state counts up to now
+	if (interface->since_us != 0 && interface->closed) {
+		closed_us += now - interface->since_us;
+	} else if (interface->since_us != 0) {
+		open_us += now - interface->since_us;
+	}
+
+	portEXIT_CRITICAL(&s_lock);
+
+	// Unwanted bytes per second of the open filter over the closed time
+	if (open_us != 0) {
+		uint64_t rate     = open_bytes * 1000000 / open_us;
+		uint64_t expected = rate * (closed_us / 1000) / 1000;
+
+		stats->saved_bytes = expected > leaked_bytes ? expected - leaked_bytes
+													 : 0;
+	}
+
+	if (ethernet_driver_get_stats(index, &driver_stats) == ESP_OK &&
+		driver_stats.spi_clock_hz != 0) {
+		stats->saved_spi_us =
+			stats->saved_bytes * 8 * 1000000 / driver_stats.spi_clock_hz;
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_mac_filter_attach(
+	uint32_t index, esp_eth_mac_t *mac,
+	const ethernet_driver_mac_filter_chip_t *chip) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || mac == NULL || chip == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	mac_filter_interface_t *interface = &s_interfaces[index];
+
+	if (interface->program_lock == NULL) {
+		interface->program_lock = xSemaphoreCreateMutex();
+
+		if (interface->program_lock == NULL) {
+			return ESP_ERR_NO_MEM;
+		}
+	}
+
+	interface->mac  = mac;
+	interface->chip = chip;
+
+	return ESP_OK;
+}
+
+void ethernet_driver_mac_filter_detach(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	mac_filter_interface_t *interface = &s_interfaces[index];
+	SemaphoreHandle_t       lock      = interface->program_lock;
+
+	// The lock is kept for the next attach
+	portENTER_CRITICAL(&s_lock);
+
+	memset(interface, 0, sizeof(mac_filter_interface_t));
+	interface->program_lock = lock;
+
+	portEXIT_CRITICAL(&s_lock);
+}
+
+void ethernet_driver_mac_filter_start(uint32_t index, esp_netif_t *netif,
+									  esp_eth_handle_t eth_handle) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	mac_filter_interface_t *interface = &s_interfaces[index];
+
+	interface->netif      = netif;
+	interface->eth_handle = eth_handle;
+
+	// A restarted driver comes back with the chip defaults
+	portENTER_CRITICAL(&s_lock);
+
+	mac_filter_set_closed(interface, false);
+
+	#if MAC_FILTER_ETH_CMD
+	for (int i = 0; i < MAC_FILTER_GROUPS; i++) {
+		interface->groups[i].programmed = false;
+	}
+	#endif // MAC_FILTER_ETH_CMD
+
+	portEXIT_CRITICAL(&s_lock);
+
+	if (interface->enabled && mac_filter_apply(interface) != ESP_OK) {
+		LOGW("Could not program the filter of interface %" PRIu32, index);
+	}
+
+	if (tcpip_callback(mac_filter_install, interface) != ERR_OK) {
+		LOGW("Multicast groups of interface %" PRIu32 " not tracked", index);
+	}
+}
+
+void ethernet_driver_mac_filter_count(uint32_t index, const uint8_t *frame,
+									  size_t length) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || length < 6 ||
+		(frame[0] & 0x01) == 0) {
+		return;
+	}
+
+	mac_filter_interface_t *interface = &s_interfaces[index];
+	bool broadcast = memcmp(frame, "\xff\xff\xff\xff\xff\xff", 6) == 0;
+	bool wanted;
+
+	portENTER_CRITICAL(&s_lock);
+
+	// Judged by the default configuration until a filter is set
+	if (broadcast) {
+		wanted = !interface->enabled || interface->config.broadcast;
+	} else {
+		wanted = (interface->enabled && interface->config.all_multicast) ||
+				 mac_filter_find(interface, frame) != NULL;
+	}
+
+	if (!wanted) {
+		interface->unwanted_frames++;
+		interface->unwanted_bytes += length;
+
+		if (interface->closed) {
+			interface->leaked_bytes += length;
+		} else {
+			interface->open_bytes += length;
+		}
+	}
+
+	portEXIT_CRITICAL(&s_lock);
+}
+#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
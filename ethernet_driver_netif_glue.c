@@ -0,0 +1,425 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_netif_glue.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+
+#include "log_utils.h"
+
+#include "ethernet_driver.h"
+#include "ethernet_driver_balance.h"
+#include "ethernet_driver_netif_glue.h"
+#include "ethernet_driver_netstack.h"
+
+LOG_TAG("ethernet_driver_netif_glue");
+
+static esp_err_t glue_input(esp_eth_handle_t eth_handle, uint8_t *buffer,
+							uint32_t length, void *priv) {
+	ethernet_driver_netif_glue_t *glue  = priv;
+	int64_t                       start = esp_timer_get_time();
+
+#if CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+	ethernet_driver_rx_task_seen(glue->index);
+#endif // CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+
+#if CONFIG_ETHERNET_DRIVER_CAPTURE
+	// As read from the chip, also the frames the filters drop
+	ethernet_driver_capture_frame(glue->index, ETHERNET_DRIVER_CAPTURE_RX,
+								  buffer, length);
+#endif // CONFIG_ETHERNET_DRIVER_CAPTURE
+
+#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+	// Frames the chip filter lets through or would have kept out
+	ethernet_driver_mac_filter_count(glue->index, buffer, length);
+#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
+
+#if CONFIG_ETHERNET_DRIVER_RX_FILTER
+	// Before any pbuf exists, counted by the filter
+	if (!ethernet_driver_rx_filter_accept(glue->index, buffer, length)) {
+		ethernet_driver_netstack_free_rx_buffer(glue->base.netif, buffer);
+
+		return ESP_OK;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_RX_FILTER
+
+	esp_err_t ret =
+		ethernet_driver_netstack_input(glue->base.netif, buffer, length);
+
+	if (ret == ESP_OK) {
+		ethernet_driver_stats_rx(glue->stats, length,
+								 esp_timer_get_time() - start);
+	} else {
+		ethernet_driver_stats_rx_dropped(glue->stats);
+	}
+
+	return ret;
+}
+
+/**
+ * Send on glue's link. With a netstack_buffer the TX queue or scheduler
+ * holds the pbuf instead of a copy, otherwise frames are queued behind the
+ * frames before them as a copy.
+ */
+static esp_err_t glue_send(ethernet_driver_netif_glue_t *glue, void *buffer,
+						   size_t len, void *netstack_buffer) {
+	esp_err_t ret;
+
+#if CONFIG_ETHERNET_DRIVER_CAPTURE
+	ethernet_driver_capture_frame(glue->index, ETHERNET_DRIVER_CAPTURE_TX,
+								  buffer, len);
+#endif // CONFIG_ETHERNET_DRIVER_CAPTURE
+
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+	if (glue->tx_sched != NULL) {
+		ret = ethernet_driver_tx_sched_send(glue->tx_sched, buffer, len,
+											netstack_buffer);
+
+		if (ret != ESP_OK) {
+			ethernet_driver_stats_tx_dropped(glue->stats);
+		}
+
+		return ret;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
+
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+	if (glue->tx_queue != NULL) {
+		ret = ethernet_driver_tx_queue_send(glue->tx_queue, buffer, len,
+											netstack_buffer);
+
+		if (ret != ESP_OK) {
+			ethernet_driver_stats_tx_dropped(glue->stats);
+		}
+
+		return ret;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+
+	ret = esp_eth_transmit(glue->eth_handle, buffer, len);
+
+	if (ret == ESP_OK) {
+		ethernet_driver_stats_tx(glue->stats, len);
+	} else {
+		ethernet_driver_stats_tx_dropped(glue->stats);
+	}
+
+	return ret;
+}
+
+static esp_err_t glue_transmit(void *h, void *buffer, size_t len) {
+	ethernet_driver_netif_glue_t *glue = h;
+
+#if CONFIG_ETHERNET_DRIVER_BALANCE
+	glue = ethernet_driver_balance_select(glue, buffer, len);
+#endif // CONFIG_ETHERNET_DRIVER_BALANCE
+
+	return glue_send(glue, buffer, len, NULL);
+}
+
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE || CONFIG_ETHERNET_DRIVER_TX_SCHED
+static esp_err_t glue_transmit_wrap(void *h, void *buffer, size_t len,
+									void *netstack_buffer) {
+	ethernet_driver_netif_glue_t *glue = h;
+
+	#if CONFIG_ETHERNET_DRIVER_BALANCE
+	glue = ethernet_driver_balance_select(glue, buffer, len);
+	#endif // CONFIG_ETHERNET_DRIVER_BALANCE
+
+	return glue_send(glue, buffer, len, netstack_buffer);
+}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE || TX_SCHED
+
+static void glue_free_rx_buffer(void *h, void *buffer) {
+	ethernet_driver_netif_glue_t *glue = h;
+
+	ethernet_driver_netstack_free_rx_buffer(glue->base.netif, buffer);
+}
+
+static esp_err_t glue_post_attach(esp_netif_t *esp_netif, void *args) {
+	ethernet_driver_netif_glue_t *glue        = args;
+	uint8_t                       mac_addr[6] = {0};
+
+	glue->base.netif = esp_netif;
+
+	esp_netif_driver_ifconfig_t driver_ifconfig = {
+		.handle                = glue,
+		.transmit              = glue_transmit,
+		.driver_free_rx_buffer = glue_free_rx_buffer,
+	};
+
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+	if (glue->tx_queue != NULL) {
+		// The pbuf is referenced until the TX task has sent it
+		driver_ifconfig.transmit_wrap = glue_transmit_wrap;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+	if (glue->tx_sched != NULL) {
+		// The pbuf is referenced until the TX task has sent it
+		driver_ifconfig.transmit_wrap = glue_transmit_wrap;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
+
+	ESP_ERROR_CHECK(esp_netif_set_driver_config(esp_netif, &driver_ifconfig));
+	ESP_ERROR_CHECK(
+		esp_eth_update_input_path(glue->eth_handle, glue_input, glue));
+
+	esp_eth_ioctl(glue->eth_handle, ETH_CMD_G_MAC_ADDR, mac_addr);
+	esp_netif_set_mac(esp_netif, mac_addr);
+
+	LOGI("Ethernet attached to netif");
+
+	return ESP_OK;
+}
+
+/** Forward the driver events of this glue's handle to its esp-netif */
+static void glue_eth_event_handler(void *arg, esp_event_base_t event_base,
+								   int32_t event_id, void *event_data) {
+	ethernet_driver_netif_glue_t *glue       = arg;
+	esp_eth_handle_t              eth_handle = *(esp_eth_handle_t *)event_data;
+
+	if (glue->eth_handle != eth_handle) {
+		return;
+	}
+
+	switch (event_id) {
+		case ETHERNET_EVENT_START:
+			esp_netif_action_start(glue->base.netif, event_base, event_id,
+								   event_data);
+#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+			// The netif was added to lwIP by now
+			ethernet_driver_mac_filter_start(glue->index, glue->base.netif,
+											 glue->eth_handle);
+#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
+			break;
+		case ETHERNET_EVENT_STOP:
+			esp_netif_action_stop(glue->base.netif, event_base, event_id,
+								  event_data);
+			break;
+		case ETHERNET_EVENT_CONNECTED:
+			esp_netif_action_connected(glue->base.netif, event_base, event_id,
+									   event_data);
+#if CONFIG_ETHERNET_DRIVER_LEASE_CACHE
+			// DHCP has just been started by esp-netif
+			ethernet_driver_lease_link_up(glue->index, glue->base.netif,
+										  glue->eth_handle);
+#endif // CONFIG_ETHERNET_DRIVER_LEASE_CACHE
+			break;
+		case ETHERNET_EVENT_DISCONNECTED:
+			ethernet_driver_stats_link_flap(glue->stats);
+			esp_netif_action_disconnected(glue->base.netif, event_base,
+										  event_id, event_data);
+			break;
+		default:
+			break;
+	}
+}
+
+static void glue_got_ip_event_handler(void *arg, esp_event_base_t event_base,
+									  int32_t event_id, void *event_data) {
+	ethernet_driver_netif_glue_t *glue  = arg;
+	ip_event_got_ip_t            *event = (ip_event_got_ip_t *)event_data;
+
+	if (glue->base.netif != event->esp_netif) {
+		return;
+	}
+
+	esp_netif_action_got_ip(glue->base.netif, event_base, event_id,
+							event_data);
+#if CONFIG_ETHERNET_DRIVER_LEASE_CACHE
+	ethernet_driver_lease_got_ip(glue->index, glue->base.netif,
+								 glue->eth_handle, &event->ip_info);
+#endif // CONFIG_ETHERNET_DRIVER_LEASE_CACHE
+#if CONFIG_ETHERNET_DRIVER_BALANCE
+	// Joins once the subnet is known, again on every new address
+	if (ethernet_driver_balance_add(glue, &event->ip_info) ==
+		ESP_ERR_INVALID_STATE) {
+		LOGE("Interface %" PRIu32 " is on another subnet, not balanced",
+			 glue->index);
+		ethernet_driver_balance_remove(glue);
+	}
+#endif // CONFIG_ETHERNET_DRIVER_BALANCE
+}
+
+static void glue_unregister_handlers(ethernet_driver_netif_glue_t *glue) {
+	if (glue->start_handler != NULL) {
+		esp_event_handler_instance_unregister(
+			ETH_EVENT, ETHERNET_EVENT_START, glue->start_handler);
+	}
+
+	if (glue->stop_handler != NULL) {
+		esp_event_handler_instance_unregister(ETH_EVENT, ETHERNET_EVENT_STOP,
+											  glue->stop_handler);
+	}
+
+	if (glue->connected_handler != NULL) {
+		esp_event_handler_instance_unregister(
+			ETH_EVENT, ETHERNET_EVENT_CONNECTED, glue->connected_handler);
+	}
+
+	if (glue->disconnected_handler != NULL) {
+		esp_event_handler_instance_unregister(
+			ETH_EVENT, ETHERNET_EVENT_DISCONNECTED,
+			glue->disconnected_handler);
+	}
+
+	if (glue->got_ip_handler != NULL) {
+		esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_ETH_GOT_IP,
+											  glue->got_ip_handler);
+	}
+}
+
+static esp_err_t glue_register_handlers(ethernet_driver_netif_glue_t *glue) {
+	esp_err_t ret = esp_event_handler_instance_register(
+		ETH_EVENT, ETHERNET_EVENT_START, glue_eth_event_handler, glue,
+		&glue->start_handler);
+
+	if (ret == ESP_OK) {
+		ret = esp_event_handler_instance_register(
+			ETH_EVENT, ETHERNET_EVENT_STOP, glue_eth_event_handler, glue,
+			&glue->stop_handler);
+	}
+
+	if (ret == ESP_OK) {
+		ret = esp_event_handler_instance_register(
+			ETH_EVENT, ETHERNET_EVENT_CONNECTED, glue_eth_event_handler, glue,
+			&glue->connected_handler);
+	}
+
+	if (ret == ESP_OK) {
+		ret = esp_event_handler_instance_register(
+			ETH_EVENT, ETHERNET_EVENT_DISCONNECTED, glue_eth_event_handler,
+			glue, &glue->disconnected_handler);
+	}
+
+	if (ret == ESP_OK) {
+		ret = esp_event_handler_instance_register(
+			IP_EVENT, IP_EVENT_ETH_GOT_IP, glue_got_ip_event_handler, glue,
+			&glue->got_ip_handler);
+	}
+
+	if (ret != ESP_OK) {
+		glue_unregister_handlers(glue);
+	}
+
+	return ret;
+}
+
+ethernet_driver_netif_glue_handle_t ethernet_driver_netif_glue_new(
+	esp_eth_handle_t eth_handle, uint32_t index) {
+	if (eth_handle == NULL) {
+		LOGE("Invalid Ethernet handle");
+
+		return NULL;
+	}
+
+	ethernet_driver_netif_glue_t *glue = calloc(1, sizeof(*glue));
+
+	if (glue == NULL) {
+		LOGE("No memory for netif glue");
+
+		return NULL;
+	}
+
+	glue->eth_handle       = eth_handle;
+	glue->index            = index;
+	glue->stats            = ethernet_driver_stats_get_handle(index);
+	glue->base.post_attach = glue_post_attach;
+
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+	glue->tx_sched = ethernet_driver_tx_sched_new(eth_handle, index);
+
+	if (glue->tx_sched == NULL) {
+		free(glue);
+
+		return NULL;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
+
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+	if (index >= ETHERNET_DRIVER_SPI_INDEX(0) &&
+		index < ETHERNET_DRIVER_SPI_INDEX(ETHERNET_DRIVER_SPI_ETHERNETS_NUM)) {
+		glue->tx_queue = ethernet_driver_tx_queue_new(eth_handle, index);
+
+		if (glue->tx_queue == NULL) {
+			free(glue);
+
+			return NULL;
+		}
+	}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+
+	if (glue_register_handlers(glue) != ESP_OK) {
+		LOGE("Could not register netif glue event handlers");
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+		ethernet_driver_tx_queue_del(glue->tx_queue);
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+		ethernet_driver_tx_sched_del(glue->tx_sched);
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
+		free(glue);
+
+		return NULL;
+	}
+
+	esp_eth_increase_reference(eth_handle);
+
+	return glue;
+}
+
+esp_err_t ethernet_driver_netif_glue_del(
+	ethernet_driver_netif_glue_handle_t glue) {
+	if (glue == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+#if CONFIG_ETHERNET_DRIVER_BALANCE
+	ethernet_driver_balance_remove(glue);
+#endif // CONFIG_ETHERNET_DRIVER_BALANCE
+	glue_unregister_handlers(glue);
+#if CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+	ethernet_driver_rx_task_forget(glue->index);
+#endif // CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+	if (glue->tx_queue != NULL) {
+		ethernet_driver_tx_queue_del(glue->tx_queue);
+	}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+	ethernet_driver_tx_sched_del(glue->tx_sched);
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
+	esp_eth_decrease_reference(glue->eth_handle);
+	free(glue);
+
+	return ESP_OK;
+}
@@ -0,0 +1,439 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_netstack.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_err.h"
+#include "esp_netif.h"
+
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/esp_netif_net_stack.h"
+
+#include "log_utils.h"
+
+#include "ethernet_driver.h"
+#include "ethernet_driver_frame_pool.h"
+#include "ethernet_driver_netstack.h"
+
+LOG_TAG("ethernet_driver_netstack");
+
+#define NETSTACK_RX_PBUFS CONFIG_ETHERNET_DRIVER_NETSTACK_RX_PBUFS
+
+struct netstack_rx_table_s;
+
+/**
+ * Custom pbuf referencing a driver buffer. It lives in the headroom of pool
+ * buffers and in the descriptor table for heap buffers. It does not point
+ * back to the binding, lwIP may free it after the unbind.
+ */
+typedef struct netstack_rx_pbuf_s {
+	struct pbuf_custom pbuf;
+	union {
+		struct netstack_rx_table_s *table; // Heap buffers
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+		ethernet_driver_frame_pool_t *frame_pool; // Pool buffers
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	};
+	uint8_t *buffer;
+} netstack_rx_pbuf_t;
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+_Static_assert(sizeof(netstack_rx_pbuf_t) <=
+				   ETHERNET_DRIVER_FRAME_POOL_HEADROOM,
+			   "Frame pool headroom too small for the RX pbuf");
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+/**
+ * Descriptors of heap buffers. The unbind releases the table, which is
+ * freed by the last descriptor lwIP returns when some are still in use.
+ */
+typedef struct netstack_rx_table_s {
+	portMUX_TYPE        lock;
+	uint32_t            free_count;
+	bool                released;
+	netstack_rx_pbuf_t *free[NETSTACK_RX_PBUFS];
+	netstack_rx_pbuf_t  pbufs[NETSTACK_RX_PBUFS];
+} netstack_rx_table_t;
+
+typedef struct netstack_binding_s {
+	esp_netif_t *netif;
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ethernet_driver_frame_pool_t *frame_pool;
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	netstack_rx_table_t             *rx_table;
+	ethernet_driver_netstack_stats_t stats;
+} netstack_binding_t;
+
+static netstack_binding_t  s_bindings[ETHERNET_DRIVER_ETHERNETS_NUM];
+static netif_linkoutput_fn s_ethernetif_linkoutput;
+
+static netstack_binding_t *netstack_get_binding(esp_netif_t *netif) {
+	for (int i = 0; i < ETHERNET_DRIVER_ETHERNETS_NUM; i++) {
+		if (s_bindings[i].netif == netif) {
+			return &s_bindings[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool netstack_pool_owns(netstack_binding_t *binding,
+							   const void         *buffer) {
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	return ethernet_driver_frame_pool_owns(binding->frame_pool, buffer);
+#else
+	return false;
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+}
+
+static void netstack_free_buffer(netstack_binding_t *binding, void *buffer) {
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	if (netstack_pool_owns(binding, buffer)) {
+		ethernet_driver_frame_pool_free(binding->frame_pool, buffer);
+		return;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	free(buffer);
+}
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+static void netstack_free_pool_rx_pbuf(struct pbuf *p) {
+	netstack_rx_pbuf_t *rx_pbuf = (netstack_rx_pbuf_t *)p;
+
+	ethernet_driver_frame_pool_free(rx_pbuf->frame_pool, rx_pbuf->buffer);
+}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+static void netstack_free_rx_pbuf(struct pbuf *p) {
+	netstack_rx_pbuf_t  *rx_pbuf = (netstack_rx_pbuf_t *)p;
+	netstack_rx_table_t *table   = rx_pbuf->table;
+	bool                 last;
+
+	free(rx_pbuf->buffer);
+
+	portENTER_CRITICAL_SAFE(&table->lock);
+	table->free[table->free_count++] = rx_pbuf;
+	last = table->released && table->free_count == NETSTACK_RX_PBUFS;
+	portEXIT_CRITICAL_SAFE(&table->lock);
+
+	// The binding is gone, this was the last one lwIP held
+	if (last) {
+		free(table);
+	}
+}
+
+/** Pool buffers carry their descriptor, heap buffers take one from the table */
+static netstack_rx_pbuf_t *netstack_get_rx_pbuf(netstack_binding_t *binding,
+												uint8_t            *buffer) {
+	netstack_rx_table_t *table   = binding->rx_table;
+	netstack_rx_pbuf_t  *rx_pbuf = NULL;
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	if (netstack_pool_owns(binding, buffer)) {
+		rx_pbuf = (netstack_rx_pbuf_t *)(buffer -
+										 ETHERNET_DRIVER_FRAME_POOL_HEADROOM);
+		rx_pbuf->frame_pool                = binding->frame_pool;
+		rx_pbuf->buffer                    = buffer;
+		rx_pbuf->pbuf.custom_free_function = netstack_free_pool_rx_pbuf;
+
+		return rx_pbuf;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	portENTER_CRITICAL_SAFE(&table->lock);
+	if (table->free_count > 0) {
+		rx_pbuf = table->free[--table->free_count];
+	}
+	portEXIT_CRITICAL_SAFE(&table->lock);
+
+	if (rx_pbuf != NULL) {
+		rx_pbuf->table                     = table;
+		rx_pbuf->buffer                    = buffer;
+		rx_pbuf->pbuf.custom_free_function = netstack_free_rx_pbuf;
+	}
+
+	return rx_pbuf;
+}
+
+static esp_err_t netstack_rx(netstack_binding_t *binding, struct netif *netif,
+							 uint8_t *buffer, uint32_t length) {
+	if (!netif_is_up(netif)) {
+		netstack_free_buffer(binding, buffer);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	binding->stats.rx_frames++;
+
+	struct pbuf        *p       = NULL;
+	netstack_rx_pbuf_t *rx_pbuf = netstack_get_rx_pbuf(binding, buffer);
+
+	if (rx_pbuf != NULL) {
+		p = pbuf_alloced_custom(PBUF_RAW, length, PBUF_REF, &rx_pbuf->pbuf,
+								buffer, length);
+	} else {
+		// Out of descriptors, copy into an lwIP pool pbuf and count it
+		p = pbuf_alloc(PBUF_RAW, length, PBUF_POOL);
+
+		if (p != NULL) {
+			pbuf_take(p, buffer, length);
+			binding->stats.rx_copied_bytes += length;
+		}
+
+		netstack_free_buffer(binding, buffer);
+	}
+
+	if (p == NULL) {
+		return ESP_ERR_NO_MEM;
+	}
+
+	if (netif->input(p, netif) != ERR_OK) {
+		pbuf_free(p);
+		return ESP_FAIL;
+	}
+
+	return ESP_OK;
+}
+
+static void netstack_input(void *h, void *buffer, size_t len, void *eb) {
+	struct netif       *netif   = h;
+	netstack_binding_t *binding =
+		netstack_get_binding(esp_netif_get_handle_from_netif_impl(netif));
+
+	if (binding == NULL) {
+		ethernetif_input(h, buffer, len, eb);
+		return;
+	}
+
+	netstack_rx(binding, netif, buffer, len);
+}
+
+static err_t netstack_linkoutput(struct netif *netif, struct pbuf *p) {
+	netstack_binding_t *binding =
+		netstack_get_binding(esp_netif_get_handle_from_netif_impl(netif));
+
+	if (binding != NULL) {
+		binding->stats.tx_frames++;
+
+		// Only chained pbufs have to be flattened before reaching the driver
+		if (p->next != NULL) {
+			binding->stats.tx_copied_bytes += p->tot_len;
+		}
+	}
+
+	if (p->next == NULL) {
+		return s_ethernetif_linkoutput(netif, p);
+	}
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	uint8_t *buffer = NULL;
+
+	if (binding != NULL && binding->frame_pool != NULL &&
+		p->tot_len <= binding->frame_pool->buffer_size) {
+		buffer = ethernet_driver_frame_pool_alloc(binding->frame_pool);
+	}
+
+	if (buffer != NULL) {
+		pbuf_copy_partial(p, buffer, p->tot_len, 0);
+
+		esp_err_t ret =
+			esp_netif_transmit(binding->netif, buffer, p->tot_len);
+
+		ethernet_driver_frame_pool_free(binding->frame_pool, buffer);
+
+		return ret == ESP_OK ? ERR_OK : ERR_IF;
+	}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+	// Let the stock output allocate the flat copy
+	return s_ethernetif_linkoutput(netif, p);
+}
+
+static err_t netstack_init(struct netif *netif) {
+	err_t ret = ethernetif_init(netif);
+
+	if (ret == ERR_OK) {
+		s_ethernetif_linkoutput = netif->linkoutput;
+		netif->linkoutput       = netstack_linkoutput;
+	}
+
+	return ret;
+}
+
+static const struct esp_netif_netstack_config s_netstack_default_eth = {
+	.lwip =
+		{
+			.init_fn  = netstack_init,
+			.input_fn = netstack_input,
+		},
+};
+
+const esp_netif_netstack_config_t *ethernet_driver_netstack_default_eth =
+	&s_netstack_default_eth;
+
+esp_err_t ethernet_driver_netstack_bind(esp_netif_t *netif) {
+	if (netif == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	if (netstack_get_binding(netif) != NULL) {
+		return ESP_OK;
+	}
+
+	netstack_binding_t *binding = netstack_get_binding(NULL);
+
+	if (binding == NULL) {
+		LOGE("No free netstack binding");
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	netstack_rx_table_t *table = calloc(1, sizeof(netstack_rx_table_t));
+
+	if (table == NULL) {
+		LOGE("Could not allocate RX pbuf descriptors");
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	for (int i = 0; i < NETSTACK_RX_PBUFS; i++) {
+		table->free[i] = &table->pbufs[i];
+	}
+
+	table->free_count = NETSTACK_RX_PBUFS;
+
+	portMUX_INITIALIZE(&table->lock);
+
+	binding->rx_table = table;
+	binding->netif    = netif;
+
+	return ESP_OK;
+}
+
+void ethernet_driver_netstack_unbind(esp_netif_t *netif) {
+	netstack_binding_t *binding =
+		netif != NULL ? netstack_get_binding(netif) : NULL;
+
+	if (binding == NULL) {
+		return;
+	}
+
+	netstack_rx_table_t *table = binding->rx_table;
+	uint32_t             in_use;
+
+	portENTER_CRITICAL(&table->lock);
+	table->released = true;
+	in_use          = NETSTACK_RX_PBUFS - table->free_count;
+	portEXIT_CRITICAL(&table->lock);
+
+	// Otherwise freed with the last RX pbuf lwIP returns
+	if (in_use == 0) {
+		free(table);
+	} else {
+		LOGW("Releasing binding with %" PRIu32 " RX pbuf(s) in use", in_use);
+	}
+
+	memset(binding, 0, sizeof(netstack_binding_t));
+}
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+esp_err_t ethernet_driver_netstack_set_frame_pool(
+	esp_netif_t *netif, ethernet_driver_frame_pool_t *frame_pool) {
+	netstack_binding_t *binding = netstack_get_binding(netif);
+
+	if (netif == NULL || binding == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	binding->frame_pool = frame_pool;
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+esp_err_t ethernet_driver_netstack_input(esp_netif_t *netif, uint8_t *buffer,
+										 uint32_t length) {
+	netstack_binding_t *binding = netstack_get_binding(netif);
+
+	if (netif == NULL || binding == NULL) {
+		free(buffer);
+
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	return netstack_rx(binding, esp_netif_get_netif_impl(netif), buffer,
+					   length);
+}
+
+void ethernet_driver_netstack_free_rx_buffer(esp_netif_t *netif,
+											 void        *buffer) {
+	netstack_binding_t *binding = netstack_get_binding(netif);
+
+	if (binding == NULL) {
+		free(buffer);
+		return;
+	}
+
+	netstack_free_buffer(binding, buffer);
+}
+
+void ethernet_driver_netstack_tx_ref(void *netstack_buffer) {
+	pbuf_ref(netstack_buffer);
+}
+
+void ethernet_driver_netstack_tx_unref(void *netstack_buffer) {
+	pbuf_free(netstack_buffer);
+}
+
+esp_err_t ethernet_driver_netstack_get_stats(
+	esp_netif_t *netif, ethernet_driver_netstack_stats_t *stats) {
+	netstack_binding_t *binding = netstack_get_binding(netif);
+
+	if (netif == NULL || binding == NULL || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	*stats = binding->stats;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_netstack_reset_stats(esp_netif_t *netif) {
+	netstack_binding_t *binding = netstack_get_binding(netif);
+
+	if (netif == NULL || binding == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	memset(&binding->stats, 0, sizeof(binding->stats));
+
+	return ESP_OK;
+}
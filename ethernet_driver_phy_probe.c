@@ -0,0 +1,503 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_phy_probe.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_PHY_AUTO
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/task.h"
+
+	#include "driver/gpio.h"
+	#include "esp_err.h"
+	#include "esp_eth.h"
+	#include "esp_rom_sys.h"
+	#include "esp_timer.h"
+	#include "nvs.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver_phy_probe.h"
+
+LOG_TAG("ethernet_driver_phy_probe");
+
+	#define PHY_PROBE_ADDRS_NUM       32
+	#define PHY_PROBE_IDR1_REG        0x02
+	#define PHY_PROBE_IDR2_REG        0x03
+	#define PHY_PROBE_RESET_ASSERT_US 100
+	#define PHY_PROBE_NVS_NAMESPACE   "eth_driver"
+	#define PHY_PROBE_NVS_KEY         "phy"
+
+/** esp-eth PHY driver of the chips of one OUI */
+typedef struct phy_probe_model_s {
+	uint32_t    oui;
+	const char *name;
+	esp_eth_phy_t *(*new_phy)(const eth_phy_config_t *config);
+} phy_probe_model_t;
+
+/** Address and OUI found by the previous boot */
+typedef struct phy_probe_cache_s {
+	uint32_t addr;
+	uint32_t oui;
+} phy_probe_cache_t;
+
+typedef struct phy_probe_s {
+	esp_eth_phy_t                      parent;
+	esp_eth_mediator_t                *eth;
+	esp_eth_phy_t                     *phy; // Found one, NULL until init
+	eth_phy_config_t                   config;
+	ethernet_driver_phy_probe_result_t result;
+} phy_probe_t;
+
+static const phy_probe_model_t s_models[] = {
+	{0x90C3, "IP101", esp_eth_phy_new_ip101},
+	{0x0732, "RTL8201", esp_eth_phy_new_rtl8201},
+	{0x01F0, "LAN87xx", esp_eth_phy_new_lan87xx},
+	{0x80017, "DP83848", esp_eth_phy_new_dp83848},
+	{0x0885, "KSZ80xx", esp_eth_phy_new_ksz80xx},
+};
+
+static const phy_probe_model_t *phy_probe_model(uint32_t oui) {
+	for (size_t i = 0; i < sizeof(s_models) / sizeof(s_models[0]); i++) {
+		if (s_models[i].oui == oui) {
+			return &s_models[i];
+		}
+	}
+
+	return NULL;
+}
+
+	#if CONFIG_ETHERNET_DRIVER_PHY_PROBE_CACHE
+static bool phy_probe_cache_load(phy_probe_cache_t *cache) {
+	size_t       size = sizeof(phy_probe_cache_t);
+	nvs_handle_t nvs;
+
+	if (nvs_open(PHY_PROBE_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+		return false;
+	}
+
+	esp_err_t ret = nvs_get_blob(nvs, PHY_PROBE_NVS_KEY, cache, &size);
+
+	nvs_close(nvs);
+
+	return ret == ESP_OK && size == sizeof(phy_probe_cache_t) &&
+		   cache->addr < PHY_PROBE_ADDRS_NUM;
+}
+
+static void phy_probe_cache_save(const phy_probe_cache_t *cache) {
+	nvs_handle_t nvs;
+
+	esp_err_t ret = nvs_open(PHY_PROBE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+
+	if (ret == ESP_OK) {
+		ret = nvs_set_blob(nvs, PHY_PROBE_NVS_KEY, cache,
+						   sizeof(phy_probe_cache_t));
+
+		if (ret == ESP_OK) {
+			ret = nvs_commit(nvs);
+		}
+
+		nvs_close(nvs);
+	}
+
+	if (ret != ESP_OK) {
+		LOGW("Could not cache PHY: %s", esp_err_to_name(ret));
+	}
+}
+	#endif // CONFIG_ETHERNET_DRIVER_PHY_PROBE_CACHE
+
+/** Cached address, then the configured one, then the rest in order */
+static int phy_probe_candidates(const phy_probe_t *probe,
+								const phy_probe_cache_t *cache, bool cached,
+								uint8_t *candidates) {
+	uint32_t seen  = 0;
+	int      count = 0;
+
+	if (cached) {
+		candidates[count++]  = cache->addr;
+		seen                |= 1U << cache->addr;
+	}
+
+	if (probe->config.phy_addr >= 0 &&
+		probe->config.phy_addr < PHY_PROBE_ADDRS_NUM &&
+		(seen & (1U << probe->config.phy_addr)) == 0) {
+		candidates[count++]  = probe->config.phy_addr;
+		seen                |= 1U << probe->config.phy_addr;
+	}
+
+	for (int addr = 0; addr < PHY_PROBE_ADDRS_NUM; addr++) {
+		if ((seen & (1U << addr)) == 0) {
+			candidates[count++] = addr;
+		}
+	}
+
+	return count;
+}
+
+/** OUI the way esp-eth assembles it, false when nothing answers at addr */
+static bool phy_probe_read_oui(phy_probe_t *probe, uint32_t addr,
+							   uint32_t *oui) {
+	esp_eth_mediator_t *eth = probe->eth;
+	uint32_t            id1 = 0;
+	uint32_t            id2 = 0;
+
+	probe->result.reads += 2;
+
+	if (eth->phy_reg_read(eth, addr, PHY_PROBE_IDR1_REG, &id1) != ESP_OK ||
+		eth->phy_reg_read(eth, addr, PHY_PROBE_IDR2_REG, &id2) != ESP_OK) {
+		return false;
+	}
+
+	// A pulled up MDIO reads all ones, a shorted one all zeros
+	if ((id1 == 0xFFFF && id2 == 0xFFFF) || (id1 == 0 && id2 == 0)) {
+		return false;
+	}
+
+	*oui = ((id1 & 0xFFFF) << 6) | ((id2 & 0xFFFF) >> 10);
+
+	return true;
+}
+
+/**
+ * Scan the candidates until a known OUI answers. A PHY only answers some
+ * time after its reset, rounds repeat until the probe timeout.
+ */
+static const phy_probe_model_t *phy_probe_scan(phy_probe_t *probe,
+											   const uint8_t *candidates,
+											   int            count) {
+	int64_t  start       = esp_timer_get_time();
+	int64_t  timeout_us  = CONFIG_ETHERNET_DRIVER_PHY_PROBE_TIMEOUT_MS * 1000;
+	uint32_t unknown     = 0;
+	int      unknown_num = -1;
+
+	do {
+		for (int i = 0; i < count; i++) {
+			uint32_t oui = 0;
+
+			if (!phy_probe_read_oui(probe, candidates[i], &oui)) {
+				continue;
+			}
+
+			const phy_probe_model_t *model = phy_probe_model(oui);
+
+			if (model != NULL) {
+				probe->result.addr     = candidates[i];
+				probe->result.oui      = oui;
+				probe->result.probe_us = esp_timer_get_time() - start;
+
+				return model;
+			}
+
+			unknown     = oui;
+			unknown_num = candidates[i];
+		}
+
+		vTaskDelay(1);
+	} while (esp_timer_get_time() - start < timeout_us);
+
+	if (unknown_num >= 0) {
+		LOGE("Unsupported PHY OUI 0x%05" PRIX32 " at address %d", unknown,
+			 unknown_num);
+	} else {
+		LOGE("No PHY answered within %d ms",
+			 CONFIG_ETHERNET_DRIVER_PHY_PROBE_TIMEOUT_MS);
+	}
+
+	return NULL;
+}
+
+static esp_err_t phy_probe_set_mediator(esp_eth_phy_t      *phy,
+										esp_eth_mediator_t *eth) {
+	if (eth == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+	probe->eth         = eth;
+
+	if (probe->phy != NULL) {
+		return probe->phy->set_mediator(probe->phy, eth);
+	}
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_probe_reset(esp_eth_phy_t *phy) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->reset(probe->phy);
+}
+
+static esp_err_t phy_probe_reset_hw(esp_eth_phy_t *phy) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy != NULL) {
+		return probe->phy->reset_hw(probe->phy);
+	}
+
+	// Same pulse as the esp-eth PHYs, before there is one to ask
+	if (probe->config.reset_gpio_num >= 0) {
+		gpio_reset_pin(probe->config.reset_gpio_num);
+		gpio_set_direction(probe->config.reset_gpio_num, GPIO_MODE_OUTPUT);
+		gpio_set_level(probe->config.reset_gpio_num, 0);
+		esp_rom_delay_us(PHY_PROBE_RESET_ASSERT_US);
+		gpio_set_level(probe->config.reset_gpio_num, 1);
+	}
+
+	return ESP_OK;
+}
+
+/** Probe on the first install, the PHY found is kept across reinstalls */
+static esp_err_t phy_probe_init(esp_eth_phy_t *phy) {
+	phy_probe_t      *probe = __containerof(phy, phy_probe_t, parent);
+	phy_probe_cache_t cache = {0};
+	uint8_t           candidates[PHY_PROBE_ADDRS_NUM];
+
+	if (probe->phy != NULL) {
+		return probe->phy->init(probe->phy);
+	}
+
+	bool cached = false;
+	#if CONFIG_ETHERNET_DRIVER_PHY_PROBE_CACHE
+	cached = phy_probe_cache_load(&cache);
+	#endif // CONFIG_ETHERNET_DRIVER_PHY_PROBE_CACHE
+
+	int count = phy_probe_candidates(probe, &cache, cached, candidates);
+
+	phy_probe_reset_hw(phy);
+
+	const phy_probe_model_t *model = phy_probe_scan(probe, candidates, count);
+
+	if (model == NULL) {
+		return ESP_ERR_NOT_FOUND;
+	}
+
+	probe->result.name     = model->name;
+	probe->result.cached   = cached && cache.addr == probe->result.addr;
+	probe->config.phy_addr = probe->result.addr;
+	probe->phy             = model->new_phy(&probe->config);
+
+	if (probe->phy == NULL) {
+		LOGE("No memory for %s PHY", model->name);
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	LOGI("%s PHY at address %" PRIu32 " in %" PRIu32 " us", model->name,
+		 probe->result.addr, probe->result.probe_us);
+
+	#if CONFIG_ETHERNET_DRIVER_PHY_PROBE_CACHE
+	if (!cached || cache.addr != probe->result.addr ||
+		cache.oui != probe->result.oui) {
+		cache.addr = probe->result.addr;
+		cache.oui  = probe->result.oui;
+
+		phy_probe_cache_save(&cache);
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_PHY_PROBE_CACHE
+
+	esp_err_t ret = probe->phy->set_mediator(probe->phy, probe->eth);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	return probe->phy->init(probe->phy);
+}
+
+static esp_err_t phy_probe_deinit(esp_eth_phy_t *phy) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_OK;
+	}
+
+	return probe->phy->deinit(probe->phy);
+}
+
+static esp_err_t phy_probe_autonego_ctrl(esp_eth_phy_t        *phy,
+										 eth_phy_autoneg_cmd_t cmd,
+										 bool *autonego_en_stat) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->autonego_ctrl(probe->phy, cmd, autonego_en_stat);
+}
+
+static esp_err_t phy_probe_get_link(esp_eth_phy_t *phy) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->get_link(probe->phy);
+}
+
+static esp_err_t phy_probe_pwrctl(esp_eth_phy_t *phy, bool enable) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->pwrctl(probe->phy, enable);
+}
+
+static esp_err_t phy_probe_set_addr(esp_eth_phy_t *phy, uint32_t addr) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy != NULL) {
+		return probe->phy->set_addr(probe->phy, addr);
+	}
+
+	// Before the probe it only moves addr to the front of the scan
+	probe->config.phy_addr = addr;
+
+	return ESP_OK;
+}
+
+static esp_err_t phy_probe_get_addr(esp_eth_phy_t *phy, uint32_t *addr) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->get_addr(probe->phy, addr);
+}
+
+static esp_err_t phy_probe_advertise_pause_ability(esp_eth_phy_t *phy,
+												   uint32_t       ability) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->advertise_pause_ability(probe->phy, ability);
+}
+
+static esp_err_t phy_probe_loopback(esp_eth_phy_t *phy, bool enable) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->loopback(probe->phy, enable);
+}
+
+static esp_err_t phy_probe_set_speed(esp_eth_phy_t *phy, eth_speed_t speed) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->set_speed(probe->phy, speed);
+}
+
+static esp_err_t phy_probe_set_duplex(esp_eth_phy_t *phy,
+									  eth_duplex_t   duplex) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy == NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	return probe->phy->set_duplex(probe->phy, duplex);
+}
+
+static esp_err_t phy_probe_del(esp_eth_phy_t *phy) {
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+
+	if (probe->phy != NULL) {
+		probe->phy->del(probe->phy);
+	}
+
+	free(probe);
+
+	return ESP_OK;
+}
+
+esp_eth_phy_t *ethernet_driver_phy_probe_new(
+	const eth_phy_config_t *phy_config) {
+	if (phy_config == NULL) {
+		LOGE("Invalid arguments");
+
+		return NULL;
+	}
+
+	phy_probe_t *probe = calloc(1, sizeof(phy_probe_t));
+
+	if (probe == NULL) {
+		LOGE("No memory for PHY probe");
+
+		return NULL;
+	}
+
+	probe->config                         = *phy_config;
+	probe->parent.set_mediator            = phy_probe_set_mediator;
+	probe->parent.reset                   = phy_probe_reset;
+	probe->parent.reset_hw                = phy_probe_reset_hw;
+	probe->parent.init                    = phy_probe_init;
+	probe->parent.deinit                  = phy_probe_deinit;
+	probe->parent.autonego_ctrl           = phy_probe_autonego_ctrl;
+	probe->parent.get_link                = phy_probe_get_link;
+	probe->parent.pwrctl                  = phy_probe_pwrctl;
+	probe->parent.set_addr                = phy_probe_set_addr;
+	probe->parent.get_addr                = phy_probe_get_addr;
+	probe->parent.advertise_pause_ability = phy_probe_advertise_pause_ability;
+	probe->parent.loopback                = phy_probe_loopback;
+	probe->parent.set_speed               = phy_probe_set_speed;
+	probe->parent.set_duplex              = phy_probe_set_duplex;
+	probe->parent.del                     = phy_probe_del;
+
+	return &probe->parent;
+}
+
+esp_err_t ethernet_driver_phy_probe_get_result(
+	esp_eth_phy_t *phy, ethernet_driver_phy_probe_result_t *result) {
+	if (phy == NULL || result == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	phy_probe_t *probe = __containerof(phy, phy_probe_t, parent);
+	*result            = probe->result;
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_PHY_AUTO
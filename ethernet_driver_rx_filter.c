@@ -0,0 +1,372 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_rx_filter.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_RX_FILTER
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/task.h"
+
+	#include "esp_err.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_rx_filter.h"
+
+LOG_TAG("ethernet_driver_rx_filter");
+
+	#define FILTER_ETH_HEADER_LEN  14
+	#define FILTER_ETH_TYPE_VLAN   0x8100
+	#define FILTER_ETH_TYPE_IPV4   0x0800
+	#define FILTER_VLAN_TAG_LEN    4
+	#define FILTER_IPV4_HEADER_MIN 20
+	#define FILTER_IPV4_PROTO_TCP  6
+	#define FILTER_IPV4_PROTO_UDP  17
+	#define FILTER_IPV4_FRAG_MASK  0x1FFF
+
+	// Fields a compiled rule compares, and fields present in a frame key
+	#define FILTER_ETHERTYPE (1 << 0)
+	#define FILTER_DST       (1 << 1)
+	#define FILTER_PROTO     (1 << 2)
+	#define FILTER_PORT      (1 << 3)
+
+typedef struct filter_rule_s {
+	uint8_t  fields;
+	uint8_t  dst_class;
+	uint8_t  ip_proto;
+	uint8_t  action;
+	uint16_t ethertype;
+	uint16_t port_min;
+	uint16_t port_max;
+} filter_rule_t;
+
+typedef struct filter_table_s {
+	filter_rule_t rules[ETHERNET_DRIVER_RX_FILTER_RULES];
+	uint32_t      count;
+} filter_table_t;
+
+/** What the rules look at, parsed once per frame */
+typedef struct filter_key_s {
+	uint8_t  fields;
+	uint8_t  dst_class;
+	uint8_t  ip_proto;
+	uint16_t ethertype;
+	uint16_t port;
+} filter_key_t;
+
+/**
+ * Two tables, the RX task reads the active one while a new set fills the
+ * other. The set returns once no reader can still see the old table.
+ */
+typedef struct filter_interface_s {
+	filter_table_t            tables[2];
+	_Atomic(filter_table_t *) active;
+	_Atomic uint32_t          readers;
+	_Atomic bool              setting;
+	_Atomic uint32_t          classified;
+	_Atomic uint32_t          dropped;
+	_Atomic uint32_t          hits[ETHERNET_DRIVER_RX_FILTER_RULES];
+} filter_interface_t;
+
+static filter_interface_t s_interfaces[ETHERNET_DRIVER_ETHERNETS_NUM];
+
+static uint16_t filter_read16(const uint8_t *data) {
+	return (data[0] << 8) | data[1];
+}
+
+static void filter_parse(const uint8_t *frame, size_t length,
+						 filter_key_t *key) {
+	size_t offset = FILTER_ETH_HEADER_LEN;
+
+	key->fields    = FILTER_ETHERTYPE | FILTER_DST;
+	key->ethertype = filter_read16(frame + 12);
+
+	if (frame[0] & 0x01) {
+		key->dst_class = memcmp(frame, "\xff\xff\xff\xff\xff\xff", 6) == 0
+						   ? ETHERNET_DRIVER_RX_FILTER_DST_BROADCAST
+						   : ETHERNET_DRIVER_RX_FILTER_DST_MULTICAST;
+	} else {
+		key->dst_class = ETHERNET_DRIVER_RX_FILTER_DST_UNICAST;
+	}
+
+	// Rules see the ethertype of a single tagged frame
+	if (key->ethertype == FILTER_ETH_TYPE_VLAN &&
+		length >= FILTER_ETH_HEADER_LEN + FILTER_VLAN_TAG_LEN) {
+		key->ethertype = filter_read16(frame + 16);
+		offset += FILTER_VLAN_TAG_LEN;
+	}
+
+	if (key->ethertype != FILTER_ETH_TYPE_IPV4 ||
+		length < offset + FILTER_IPV4_HEADER_MIN) {
+		return;
+	}
+
+	const uint8_t *ip     = frame + offset;
+	size_t         ip_len = (ip[0] & 0x0F) * 4;
+
+	key->fields   |= FILTER_PROTO;
+	key->ip_proto  = ip[9];
+
+	// Only the first fragment carries the ports
+	if ((key->ip_proto == FILTER_IPV4_PROTO_TCP ||
+		 key->ip_proto == FILTER_IPV4_PROTO_UDP) &&
+		(filter_read16(ip + 6) & FILTER_IPV4_FRAG_MASK) == 0 &&
+		length >= offset + ip_len + 4) {
+		key->fields |= FILTER_PORT;
+		key->port    = filter_read16(ip + ip_len + 2);
+	}
+}
+
+static bool filter_match(const filter_rule_t *rule, const filter_key_t *key) {
+	// A field the rule compares and the frame lacks fails the rule
+	if ((rule->fields & key->fields) != rule->fields) {
+		return false;
+	}
+
+	return (!(rule->fields & FILTER_ETHERTYPE) ||
+			rule->ethertype == key->ethertype) &&
+		   (!(rule->fields & FILTER_DST) ||
+			(rule->dst_class & key->dst_class) != 0) &&
+		   (!(rule->fields & FILTER_PROTO) ||
+			rule->ip_proto == key->ip_proto) &&
+		   (!(rule->fields & FILTER_PORT) ||
+			(key->port >= rule->port_min && key->port <= rule->port_max));
+}
+
+static esp_err_t filter_compile(const ethernet_driver_rx_filter_rule_t *rule,
+								filter_rule_t *compiled) {
+	bool ports = rule->port_min != 0 || rule->port_max != 0;
+
+	if (rule->action > ETHERNET_DRIVER_RX_FILTER_COUNT ||
+		(ports && rule->port_max < rule->port_min) ||
+		(ports && rule->ip_proto != 0 &&
+		 rule->ip_proto != FILTER_IPV4_PROTO_TCP &&
+		 rule->ip_proto != FILTER_IPV4_PROTO_UDP) ||
+		((ports || rule->ip_proto != 0) && rule->ethertype != 0 &&
+		 rule->ethertype != FILTER_ETH_TYPE_IPV4)) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	memset(compiled, 0, sizeof(filter_rule_t));
+
+	compiled->action    = rule->action;
+	compiled->ethertype = rule->ethertype;
+	compiled->dst_class = rule->dst_class;
+	compiled->ip_proto  = rule->ip_proto;
+	compiled->port_min  = rule->port_min;
+	compiled->port_max  = rule->port_max;
+
+	if (rule->ethertype != 0) {
+		compiled->fields |= FILTER_ETHERTYPE;
+	}
+
+	if (rule->dst_class != 0) {
+		compiled->fields |= FILTER_DST;
+	}
+
+	// The key only has a protocol for IPv4 and ports for TCP and UDP
+	if (rule->ip_proto != 0) {
+		compiled->fields |= FILTER_PROTO;
+	}
+
+	if (ports) {
+		compiled->fields |= FILTER_PORT;
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_filter_set(
+	uint32_t index, const ethernet_driver_rx_filter_rule_t *rules,
+	size_t count) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM ||
+		count > ETHERNET_DRIVER_RX_FILTER_RULES ||
+		(rules == NULL && count > 0)) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	filter_interface_t *interface = &s_interfaces[index];
+
+	if (atomic_exchange(&interface->setting, true)) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	filter_table_t *active = atomic_load(&interface->active);
+	filter_table_t *table  = active == &interface->tables[0]
+							   ? &interface->tables[1]
+							   : &interface->tables[0];
+
+	for (size_t i = 0; i < count; i++) {
+		if (filter_compile(&rules[i], &table->rules[i]) != ESP_OK) {
+			LOGE("Invalid RX filter rule %d", (int)i);
+			atomic_store(&interface->setting, false);
+
+			return ESP_ERR_INVALID_ARG;
+		}
+	}
+
+	table->count = count;
+
+	atomic_store(&interface->active, count > 0 ? table : NULL);
+
+	// The RX task may still be evaluating the old table
+	while (atomic_load(&interface->readers) != 0) {
+		vTaskDelay(1);
+	}
+
+	ethernet_driver_rx_filter_reset_stats(index);
+	atomic_store(&interface->setting, false);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_filter_get(
+	uint32_t index, ethernet_driver_rx_filter_rule_t *rules, size_t *count) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || rules == NULL ||
+		count == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	filter_interface_t *interface = &s_interfaces[index];
+
+	// A set in progress could be filling the table next to the active one
+	if (atomic_exchange(&interface->setting, true)) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	filter_table_t *table = atomic_load(&interface->active);
+
+	*count = table != NULL ? table->count : 0;
+
+	for (size_t i = 0; i < *count; i++) {
+		const filter_rule_t *compiled = &table->rules[i];
+
+		memset(&rules[i], 0, sizeof(ethernet_driver_rx_filter_rule_t));
+
+		rules[i].ethertype = compiled->ethertype;
+		rules[i].dst_class = compiled->dst_class;
+		rules[i].ip_proto  = compiled->ip_proto;
+		rules[i].port_min  = compiled->port_min;
+		rules[i].port_max  = compiled->port_max;
+		rules[i].action    = compiled->action;
+	}
+
+	atomic_store(&interface->setting, false);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_filter_get_stats(
+	uint32_t index, ethernet_driver_rx_filter_stats_t *stats) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	filter_interface_t *interface = &s_interfaces[index];
+
+	stats->classified = RELAXED_LOAD(interface->classified);
+	stats->dropped    = RELAXED_LOAD(interface->dropped);
+
+	for (int i = 0; i < ETHERNET_DRIVER_RX_FILTER_RULES; i++) {
+		stats->hits[i] = RELAXED_LOAD(interface->hits[i]);
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_filter_reset_stats(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	filter_interface_t *interface = &s_interfaces[index];
+
+	RELAXED_CLEAR(interface->classified);
+	RELAXED_CLEAR(interface->dropped);
+
+	for (int i = 0; i < ETHERNET_DRIVER_RX_FILTER_RULES; i++) {
+		RELAXED_CLEAR(interface->hits[i]);
+	}
+
+	return ESP_OK;
+}
+
+bool ethernet_driver_rx_filter_accept(uint32_t index, const uint8_t *frame,
+									  size_t length) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM ||
+		length < FILTER_ETH_HEADER_LEN) {
+		return true;
+	}
+
+	filter_interface_t *interface = &s_interfaces[index];
+	bool                accept    = true;
+	filter_key_t        key;
+
+	// Interfaces without rules pay a single load
+	if (RELAXED_LOAD(interface->active) == NULL) {
+		return true;
+	}
+
+	atomic_fetch_add(&interface->readers, 1);
+
+	filter_table_t *table = atomic_load(&interface->active);
+
+	if (table != NULL) {
+		filter_parse(frame, length, &key);
+		RELAXED_ADD(interface->classified, 1);
+
+		for (uint32_t i = 0; i < table->count; i++) {
+			const filter_rule_t *rule = &table->rules[i];
+
+			if (!filter_match(rule, &key)) {
+				continue;
+			}
+
+			RELAXED_ADD(interface->hits[i], 1);
+
+			if (rule->action == ETHERNET_DRIVER_RX_FILTER_COUNT) {
+				continue;
+			}
+
+			if (rule->action == ETHERNET_DRIVER_RX_FILTER_DROP) {
+				RELAXED_ADD(interface->dropped, 1);
+				accept = false;
+			}
+
+			break;
+		}
+	}
+
+	atomic_fetch_sub(&interface->readers, 1);
+
+	return accept;
+}
+#endif // CONFIG_ETHERNET_DRIVER_RX_FILTER
@@ -0,0 +1,503 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_rx_poll.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/semphr.h"
+	#include "freertos/task.h"
+
+	#include "driver/gpio.h"
+	#include "esp_err.h"
+	#include "esp_eth.h"
+	#include "esp_heap_caps.h"
+	#include "esp_timer.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_rx_poll.h"
+
+LOG_TAG("ethernet_driver_rx_poll");
+
+	#define KSZ8851_ISR        0x92
+	#define KSZ8851_ISR_RXIS   (1 << 13)
+	#define KSZ8851_RXFCTR     0x9C
+	#define KSZ8851_RXFC_MASK  0xFF00
+	#define KSZ8851_RXFC_SHIFT 8
+
+/**
+ * The MAC drivers keep their RX task and ISR private, so the hybrid mode
+ * hooks the MAC methods instead. Every receive goes through the module
+ * lock, which keeps the driver's own RX task and the poll task from
+ * interleaving the SPI transactions of one frame. The lock is recursive,
+ * as the DM9051 receive restarts the MAC through the hooked stop and start
+ * when its RX pointer is corrupted.
+ */
+typedef struct rx_poll_s {
+	esp_eth_mac_t                    *mac;
+	esp_eth_mediator_t               *mediator;
+	SemaphoreHandle_t                 lock;
+	TaskHandle_t                      task;
+	TaskHandle_t                      deleter; // Waits for the task to exit
+	volatile bool                     exiting;
+	int                               int_gpio;
+	int                               int_active_level;
+	ethernet_driver_rx_poll_pending_t pending;
+	uint32_t                          pending_frames; // Counted, not received
+	ethernet_driver_rx_poll_config_t  config;
+	bool                              running;
+	bool                              polling;
+	int64_t                           window_start_us;
+	uint32_t                          window_frames;
+	ethernet_driver_rx_poll_stats_t   stats;
+	esp_err_t (*set_mediator)(esp_eth_mac_t *mac, esp_eth_mediator_t *eth);
+	esp_err_t (*start)(esp_eth_mac_t *mac);
+	esp_err_t (*stop)(esp_eth_mac_t *mac);
+	esp_err_t (*receive)(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *length);
+	esp_err_t (*del)(esp_eth_mac_t *mac);
+} rx_poll_t;
+
+static rx_poll_t s_rx_poll[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
+
+static rx_poll_t *rx_poll_find(esp_eth_mac_t *mac) {
+	for (int i = 0; i < CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM; i++) {
+		if (s_rx_poll[i].mac == mac) {
+			return &s_rx_poll[i];
+		}
+	}
+
+	return NULL;
+}
+
+static rx_poll_t *rx_poll_from_index(uint32_t index) {
+	if (index < ETHERNET_DRIVER_SPI_INDEX(0) ||
+		index >= ETHERNET_DRIVER_SPI_INDEX(
+					 CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM)) {
+		return NULL;
+	}
+
+	rx_poll_t *poll = &s_rx_poll[index - ETHERNET_DRIVER_SPI_INDEX(0)];
+
+	return poll->mac != NULL ? poll : NULL;
+}
+
+// Called with the lock held
+static void rx_poll_set_polling(rx_poll_t *poll, bool polling) {
+	if (poll->polling == polling) {
+		return;
+	}
+
+	poll->polling = polling;
+
+	if (polling) {
+		gpio_intr_disable(poll->int_gpio);
+		poll->stats.irq_to_poll++;
+	} else {
+		poll->window_frames = 0;
+		poll->stats.poll_to_irq++;
+		gpio_intr_enable(poll->int_gpio);
+	}
+}
+
+// Called with the lock held
+static bool rx_poll_has_frame(rx_poll_t *poll) {
+	if (poll->pending == NULL) {
+		// The receive returns an empty frame when there is none
+		return true;
+	}
+
+	if (poll->pending_frames == 0) {
+		esp_err_t ret = poll->pending(poll->mac, &poll->pending_frames);
+
+		if (ret != ESP_OK) {
+			// Receiving blindly would read garbage, the driver's RX task can
+			LOGE("Frame count of SPI module %d unreadable (%s), IRQ mode",
+				 (int)(poll - s_rx_poll), esp_err_to_name(ret));
+
+			poll->config.mode    = ETHERNET_DRIVER_RX_POLL_MODE_IRQ;
+			poll->pending_frames = 0;
+			rx_poll_set_polling(poll, false);
+
+			return false;
+		}
+	}
+
+	return poll->pending_frames > 0;
+}
+
+/** Hand up to budget frames to the stack, returns how many were found */
+static uint32_t rx_poll_pass(rx_poll_t *poll) {
+	uint32_t frames = 0;
+
+	while (frames < poll->config.budget) {
+		uint32_t length = ETH_MAX_PACKET_SIZE;
+		uint8_t *buffer = heap_caps_malloc(length, MALLOC_CAP_DMA);
+
+		if (buffer == NULL) {
+			LOGE("No memory for receive buffer");
+			break;
+		}
+
+		xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+
+		if (!poll->polling || !rx_poll_has_frame(poll) ||
+			poll->receive(poll->mac, buffer, &length) != ESP_OK ||
+			length == 0) {
+			// A failed receive leaves the count of the chip unknown
+			poll->pending_frames = 0;
+			xSemaphoreGiveRecursive(poll->lock);
+			free(buffer);
+			break;
+		}
+
+		if (poll->pending_frames > 0) {
+			poll->pending_frames--;
+		}
+
+		// The mediator stays valid while the MAC is started
+		poll->mediator->stack_input(poll->mediator, buffer, length);
+		poll->stats.polled_frames++;
+		xSemaphoreGiveRecursive(poll->lock);
+
+		frames++;
+	}
+
+	poll->stats.poll_passes++;
+
+	#if CONFIG_ETHERNET_DRIVER_TRACE_BURSTS
+	if (frames > 0) {
+		ethernet_driver_trace_write(
+			ETHERNET_DRIVER_SPI_INDEX(poll - s_rx_poll),
+			ETHERNET_DRIVER_TRACE_RX_BURST, &frames, sizeof(frames));
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_BURSTS
+
+	return frames;
+}
+
+static void rx_poll_task(void *arg) {
+	rx_poll_t *poll        = arg;
+	uint32_t   idle_passes = 0;
+
+	for (;;) {
+		if (poll->exiting) {
+			// Outside the lock, which is deleted next
+			xTaskNotifyGive(poll->deleter);
+			vTaskDelete(NULL);
+		}
+
+		if (!poll->polling) {
+			// Woken by the receive hook when the rate crosses the threshold
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+			if (poll->exiting) {
+				continue;
+			}
+
+			xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+
+			if (poll->running &&
+				poll->config.mode == ETHERNET_DRIVER_RX_POLL_MODE_HYBRID) {
+				rx_poll_set_polling(poll, true);
+			}
+
+			xSemaphoreGiveRecursive(poll->lock);
+
+			idle_passes = 0;
+			continue;
+		}
+
+		uint32_t frames = rx_poll_pass(poll);
+
+		if (frames >= poll->config.budget) {
+			// More frames are likely waiting, let equal priorities run first
+			idle_passes = 0;
+			taskYIELD();
+			continue;
+		}
+
+		idle_passes = frames > 0 ? 0 : idle_passes + 1;
+
+		xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+
+		/*
+		 * The chip holds its interrupt line until the driver acknowledges
+		 * it, which the driver's RX task does on its periodic check while
+		 * the interrupt is masked. Unmasking before that would lose the
+		 * edge of the next frame.
+		 */
+		if (poll->config.mode != ETHERNET_DRIVER_RX_POLL_MODE_HYBRID ||
+			(idle_passes >= poll->config.idle_passes &&
+			 gpio_get_level(poll->int_gpio) != poll->int_active_level)) {
+			rx_poll_set_polling(poll, false);
+		}
+
+		xSemaphoreGiveRecursive(poll->lock);
+
+		if (poll->polling) {
+			vTaskDelay(pdMS_TO_TICKS(poll->config.period_ms) + 1);
+		}
+	}
+}
+
+static esp_err_t rx_poll_hook_set_mediator(esp_eth_mac_t      *mac,
+										   esp_eth_mediator_t *eth) {
+	rx_poll_t *poll = rx_poll_find(mac);
+
+	poll->mediator = eth;
+
+	return poll->set_mediator(mac, eth);
+}
+
+static esp_err_t rx_poll_hook_start(esp_eth_mac_t *mac) {
+	rx_poll_t *poll = rx_poll_find(mac);
+	esp_err_t  ret  = poll->start(mac);
+
+	if (ret == ESP_OK) {
+		xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+		poll->running = true;
+		xSemaphoreGiveRecursive(poll->lock);
+	}
+
+	return ret;
+}
+
+static esp_err_t rx_poll_hook_stop(esp_eth_mac_t *mac) {
+	rx_poll_t *poll = rx_poll_find(mac);
+
+	// Give the interrupt back to the driver before it stops
+	xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+	poll->running        = false;
+	poll->pending_frames = 0;
+	rx_poll_set_polling(poll, false);
+	xSemaphoreGiveRecursive(poll->lock);
+
+	return poll->stop(mac);
+}
+
+static esp_err_t rx_poll_hook_receive(esp_eth_mac_t *mac, uint8_t *buf,
+									  uint32_t *length) {
+	rx_poll_t *poll = rx_poll_find(mac);
+
+	xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+
+	esp_err_t ret = poll->receive(mac, buf, length);
+
+	if (ret == ESP_OK && *length > 0) {
+		poll->stats.irq_frames++;
+
+		// Frames the driver's RX task took from the count of the last pass
+		if (poll->pending_frames > 0) {
+			poll->pending_frames--;
+		}
+
+		if (!poll->polling &&
+			poll->config.mode == ETHERNET_DRIVER_RX_POLL_MODE_HYBRID) {
+			int64_t now = esp_timer_get_time();
+
+			if (now - poll->window_start_us >
+				(int64_t)poll->config.window_ms * 1000) {
+				poll->window_start_us = now;
+				poll->window_frames   = 0;
+			}
+
+			if (++poll->window_frames == poll->config.enter_frames) {
+				xTaskNotifyGive(poll->task);
+			}
+		}
+	}
+
+	xSemaphoreGiveRecursive(poll->lock);
+
+	return ret;
+}
+
+static esp_err_t rx_poll_hook_del(esp_eth_mac_t *mac) {
+	rx_poll_t *poll = rx_poll_find(mac);
+	esp_err_t (*del)(esp_eth_mac_t *mac) = poll->del;
+
+	// Let the task leave its pass, it must not be killed holding the lock
+	poll->deleter = xTaskGetCurrentTaskHandle();
+	poll->exiting = true;
+	xTaskNotifyGive(poll->task);
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	vSemaphoreDelete(poll->lock);
+	memset(poll, 0, sizeof(rx_poll_t));
+
+	return del(mac);
+}
+
+esp_err_t ethernet_driver_rx_poll_set_mode(
+	uint32_t index, ethernet_driver_rx_poll_mode_t mode) {
+	rx_poll_t *poll = rx_poll_from_index(index);
+
+	if (poll == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+	poll->config.mode   = mode;
+	poll->window_frames = 0;
+	xSemaphoreGiveRecursive(poll->lock);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_poll_get_stats(
+	uint32_t index, ethernet_driver_rx_poll_stats_t *stats) {
+	rx_poll_t *poll = rx_poll_from_index(index);
+
+	if (poll == NULL || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+	*stats         = poll->stats;
+	stats->polling = poll->polling;
+	xSemaphoreGiveRecursive(poll->lock);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_poll_reset_stats(uint32_t index) {
+	rx_poll_t *poll = rx_poll_from_index(index);
+
+	if (poll == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	xSemaphoreTakeRecursive(poll->lock, portMAX_DELAY);
+	memset(&poll->stats, 0, sizeof(ethernet_driver_rx_poll_stats_t));
+	xSemaphoreGiveRecursive(poll->lock);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_poll_attach(
+	uint32_t num, esp_eth_mac_t *mac, int int_gpio, int int_active_level,
+	ethernet_driver_rx_poll_pending_t       pending,
+	const ethernet_driver_rx_poll_config_t *config,
+	const eth_mac_config_t                 *mac_config) {
+	if (num >= CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM || mac == NULL ||
+		int_gpio < 0 || config == NULL || mac_config == NULL ||
+		config->budget == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	rx_poll_t *poll = &s_rx_poll[num];
+
+	if (poll->mac != NULL) {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	poll->lock = xSemaphoreCreateRecursiveMutex();
+
+	if (poll->lock == NULL) {
+		LOGE("No memory for RX poll lock");
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	poll->int_gpio         = int_gpio;
+	poll->int_active_level = int_active_level;
+	poll->pending          = pending;
+	poll->config           = *config;
+
+	BaseType_t core_num = tskNO_AFFINITY;
+
+	// Like the RX task of the MAC, on the core attaching runs on
+	if (mac_config->flags & ETH_MAC_FLAG_PIN_TO_CORE) {
+		core_num = xPortGetCoreID();
+	}
+
+	if (xTaskCreatePinnedToCore(rx_poll_task, "eth_rx_poll",
+								mac_config->rx_task_stack_size, poll,
+								mac_config->rx_task_prio, &poll->task,
+								core_num) != pdPASS) {
+		LOGE("Could not create RX poll task");
+		vSemaphoreDelete(poll->lock);
+		poll->lock = NULL;
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	poll->set_mediator = mac->set_mediator;
+	poll->start        = mac->start;
+	poll->stop         = mac->stop;
+	poll->receive      = mac->receive;
+	poll->del          = mac->del;
+	poll->mac          = mac;
+
+	mac->set_mediator = rx_poll_hook_set_mediator;
+	mac->start        = rx_poll_hook_start;
+	mac->stop         = rx_poll_hook_stop;
+	mac->receive      = rx_poll_hook_receive;
+	mac->del          = rx_poll_hook_del;
+
+	return ESP_OK;
+}
+
+	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+/**
+ * The receive of the KSZ8851SNL reads the header of the next frame in its
+ * queue and reports an invalid frame when there is none, its own RX task
+ * reads the count first. The MAC maps its PHY register accessors onto the
+ * chip registers under its SPI lock, the integrated PHY driver uses them
+ * the same way.
+ */
+esp_err_t ethernet_driver_rx_poll_pending_ksz8851(esp_eth_mac_t *mac,
+												  uint32_t      *frames) {
+	uint32_t isr    = 0;
+	uint32_t rxfctr = 0;
+
+	*frames = 0;
+
+	esp_err_t ret = mac->read_phy_reg(mac, 0, KSZ8851_ISR, &isr);
+
+	if (ret != ESP_OK || (isr & KSZ8851_ISR_RXIS) == 0) {
+		return ret;
+	}
+
+	// Acknowledging latches the count and releases the interrupt line
+	ret = mac->write_phy_reg(mac, 0, KSZ8851_ISR, KSZ8851_ISR_RXIS);
+
+	if (ret == ESP_OK) {
+		ret = mac->read_phy_reg(mac, 0, KSZ8851_RXFCTR, &rxfctr);
+	}
+
+	if (ret == ESP_OK) {
+		*frames = (rxfctr & KSZ8851_RXFC_MASK) >> KSZ8851_RXFC_SHIFT;
+	}
+
+	return ret;
+}
+	#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
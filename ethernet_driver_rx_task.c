@@ -0,0 +1,217 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_rx_task.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_timer.h"
+
+#include "log_utils.h"
+
+#include "ethernet_driver.h"
+#include "ethernet_driver_atomic.h"
+#include "ethernet_driver_rx_task.h"
+
+LOG_TAG("ethernet_driver_rx_task");
+
+// MAC constructors only allocate and create their task
+#define RX_TASK_RUN_STACK_SIZE 4096
+
+typedef struct rx_task_run_s {
+	void (*fn)(void *arg);
+	void        *arg;
+	TaskHandle_t caller;
+} rx_task_run_t;
+
+#if CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+/**
+ * base_* is where the reported time starts, taken again on a new task. The
+ * 32 bit run time counter wraps after 71 minutes, so the run time is summed
+ * from the difference to the last sample instead.
+ */
+typedef struct rx_task_interface_s {
+	_Atomic(TaskHandle_t) task;
+	TaskHandle_t          base_task;
+	uint32_t              last_run_time;
+	uint64_t              run_time_us;
+	int64_t               base_us;
+} rx_task_interface_t;
+
+static rx_task_interface_t s_interfaces[ETHERNET_DRIVER_ETHERNETS_NUM];
+#endif // CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+
+void ethernet_driver_rx_task_mac_config(
+	const ethernet_driver_rx_task_config_t *rx_task,
+	const eth_mac_config_t *mac_config, eth_mac_config_t *rx_mac_config) {
+	*rx_mac_config = *mac_config;
+
+	if (rx_task == NULL) {
+		return;
+	}
+
+	if (rx_task->pin_to_core) {
+		rx_mac_config->flags |= ETH_MAC_FLAG_PIN_TO_CORE;
+	}
+
+	if (rx_task->prio != 0) {
+		rx_mac_config->rx_task_prio = rx_task->prio;
+	}
+
+	if (rx_task->stack_size != 0) {
+		rx_mac_config->rx_task_stack_size = rx_task->stack_size;
+	}
+}
+
+static void rx_task_run_task(void *arg) {
+	rx_task_run_t *run = arg;
+
+	run->fn(run->arg);
+
+	xTaskNotifyGive(run->caller);
+	vTaskDelete(NULL);
+}
+
+esp_err_t ethernet_driver_rx_task_run(
+	const ethernet_driver_rx_task_config_t *rx_task, void (*fn)(void *arg),
+	void *arg) {
+	if (fn == NULL || (rx_task != NULL && rx_task->pin_to_core &&
+					   rx_task->core >= portNUM_PROCESSORS)) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	if (rx_task == NULL || !rx_task->pin_to_core) {
+		fn(arg);
+
+		return ESP_OK;
+	}
+
+	rx_task_run_t run = {
+		.fn     = fn,
+		.arg    = arg,
+		.caller = xTaskGetCurrentTaskHandle(),
+	};
+
+	// Even on the caller's core, an unpinned caller may migrate meanwhile
+	if (xTaskCreatePinnedToCore(rx_task_run_task, "eth_rx_task_run",
+								RX_TASK_RUN_STACK_SIZE, &run,
+								uxTaskPriorityGet(NULL), NULL,
+								rx_task->core) != pdPASS) {
+		LOGE("Could not run on core %d", rx_task->core);
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	return ESP_OK;
+}
+
+#if CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+void ethernet_driver_rx_task_seen(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	rx_task_interface_t *interface = &s_interfaces[index];
+	TaskHandle_t         task      = xTaskGetCurrentTaskHandle();
+
+	// Only written again when polling takes over or the task changed
+	if (RELAXED_LOAD(interface->task) != task) {
+		RELAXED_STORE(interface->task, task);
+	}
+}
+
+void ethernet_driver_rx_task_forget(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return;
+	}
+
+	// The MAC and its task may be deleted next
+	atomic_store(&s_interfaces[index].task, NULL);
+	s_interfaces[index].base_task = NULL;
+}
+
+esp_err_t ethernet_driver_rx_task_get_stats(
+	uint32_t index, ethernet_driver_rx_task_stats_t *stats) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	rx_task_interface_t *interface = &s_interfaces[index];
+	TaskHandle_t         task      = RELAXED_LOAD(interface->task);
+	TaskStatus_t         status;
+
+	if (task == NULL) {
+		return ESP_ERR_NOT_FOUND;
+	}
+
+	vTaskGetInfo(task, &status, pdTRUE, eInvalid);
+
+	int64_t now = esp_timer_get_time();
+
+	if (interface->base_task != task) {
+		interface->base_task     = task;
+		interface->last_run_time = status.ulRunTimeCounter;
+		interface->run_time_us   = 0;
+		interface->base_us       = now;
+	}
+
+	// Modulo 2^32, right across one wrap of the counter
+	interface->run_time_us +=
+		(uint32_t)(status.ulRunTimeCounter - interface->last_run_time);
+	interface->last_run_time = status.ulRunTimeCounter;
+
+	stats->core        = xTaskGetAffinity(task);
+	stats->prio        = status.uxCurrentPriority;
+	stats->stack_free  = status.usStackHighWaterMark;
+	stats->run_time_us = interface->run_time_us;
+	stats->elapsed_us  = now - interface->base_us;
+
+	if (stats->elapsed_us > 0) {
+		stats->cpu_permille = stats->run_time_us * 1000 / stats->elapsed_us;
+	} else {
+		stats->cpu_permille = 0;
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_rx_task_reset_stats(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	// The next ethernet_driver_rx_task_get_stats() starts over
+	s_interfaces[index].base_task = NULL;
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
@@ -0,0 +1,545 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_spi_calibration.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION
+
+	#include "driver/spi_master.h"
+	#include "esp_err.h"
+	#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+		#include "nvs.h"
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_spi_calibration.h"
+
+LOG_TAG("ethernet_driver_spi_calibration");
+
+	#define CALIBRATION_MHZ(mhz) ((mhz) * 1000 * 1000)
+	#define CALIBRATION_MAX_HZ \
+		CALIBRATION_MHZ(CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_MAX_MHZ)
+	#define CALIBRATION_STEP_HZ \
+		CALIBRATION_MHZ(CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_STEP_MHZ)
+	#define CALIBRATION_ITERATIONS \
+		CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_ITERATIONS
+	#define CALIBRATION_PATTERN_SIZE_MAX 64
+
+	#define W5500_VERSIONR       0x0039
+	#define W5500_VERSION        0x04
+	#define W5500_BSB_COMMON     0x00
+	#define W5500_BSB_SOCK0_TX   0x02
+	#define W5500_CONTROL_WRITE  (1 << 2)
+
+	#define DM9051_SPI_READ      0
+	#define DM9051_SPI_WRITE     1
+	#define DM9051_VIDL          0x28
+	#define DM9051_ID            0x90510A46
+	#define DM9051_MAR           0x16
+
+	#define KSZ8851_SPI_READ     0
+	#define KSZ8851_SPI_WRITE    1
+	#define KSZ8851_CIDER        0xC0
+	#define KSZ8851_CHIP_ID      0x8870
+	#define KSZ8851_CHIP_ID_MASK 0xFFF0
+	#define KSZ8851_MARL         0x10
+
+/**
+ * Chip access used by the calibration. write/read move pattern_size bytes
+ * to and from registers the MAC driver initializes again afterwards.
+ */
+typedef struct calibration_chip_s {
+	esp_err_t (*check_id)(spi_device_handle_t device);
+	esp_err_t (*write)(spi_device_handle_t device, const uint8_t *data);
+	esp_err_t (*read)(spi_device_handle_t device, uint8_t *data);
+	size_t pattern_size;
+} calibration_chip_t;
+
+	#if CONFIG_ETHERNET_DRIVER_USE_W5500
+// Address in the command phase, block select and R/W in the address phase
+static esp_err_t w5500_access(spi_device_handle_t device, uint16_t address,
+							  uint8_t block, uint8_t control, void *data,
+							  size_t size) {
+	spi_transaction_t trans = {
+		.cmd    = address,
+		.addr   = (block << 3) | control,
+		.length = size * 8,
+	};
+
+	if (control & W5500_CONTROL_WRITE) {
+		trans.tx_buffer = data;
+	} else {
+		trans.rx_buffer = data;
+	}
+
+	return spi_device_polling_transmit(device, &trans);
+}
+
+static esp_err_t w5500_check_id(spi_device_handle_t device) {
+	uint8_t   version = 0;
+	esp_err_t ret     = w5500_access(device, W5500_VERSIONR, W5500_BSB_COMMON,
+									 0, &version, sizeof(version));
+
+	if (ret == ESP_OK && version != W5500_VERSION) {
+		ret = ESP_ERR_INVALID_RESPONSE;
+	}
+
+	return ret;
+}
+
+static esp_err_t w5500_write(spi_device_handle_t device, const uint8_t *data) {
+	return w5500_access(device, 0, W5500_BSB_SOCK0_TX, W5500_CONTROL_WRITE,
+						(void *)data, CALIBRATION_PATTERN_SIZE_MAX);
+}
+
+static esp_err_t w5500_read(spi_device_handle_t device, uint8_t *data) {
+	return w5500_access(device, 0, W5500_BSB_SOCK0_TX, 0, data,
+						CALIBRATION_PATTERN_SIZE_MAX);
+}
+
+static const calibration_chip_t s_w5500 = {
+	.check_id     = w5500_check_id,
+	.write        = w5500_write,
+	.read         = w5500_read,
+	.pattern_size = CALIBRATION_PATTERN_SIZE_MAX,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051
+static esp_err_t dm9051_read_reg(spi_device_handle_t device, uint8_t reg,
+								 uint8_t *value) {
+	spi_transaction_t trans = {
+		.flags  = SPI_TRANS_USE_RXDATA,
+		.cmd    = DM9051_SPI_READ,
+		.addr   = reg,
+		.length = 8,
+	};
+	esp_err_t ret = spi_device_polling_transmit(device, &trans);
+
+	*value = trans.rx_data[0];
+
+	return ret;
+}
+
+static esp_err_t dm9051_write_reg(spi_device_handle_t device, uint8_t reg,
+								  uint8_t value) {
+	spi_transaction_t trans = {
+		.flags   = SPI_TRANS_USE_TXDATA,
+		.cmd     = DM9051_SPI_WRITE,
+		.addr    = reg,
+		.length  = 8,
+		.tx_data = {value},
+	};
+
+	return spi_device_polling_transmit(device, &trans);
+}
+
+static esp_err_t dm9051_check_id(spi_device_handle_t device) {
+	uint32_t  id  = 0;
+	esp_err_t ret = ESP_OK;
+
+	// VIDL, VIDH, PIDL and PIDH
+	for (int i = 0; ret == ESP_OK && i < 4; i++) {
+		uint8_t value = 0;
+
+		ret = dm9051_read_reg(device, DM9051_VIDL + i, &value);
+		id |= (uint32_t)value << (i * 8);
+	}
+
+	if (ret == ESP_OK && id != DM9051_ID) {
+		ret = ESP_ERR_INVALID_RESPONSE;
+	}
+
+	return ret;
+}
+
+// The eight multicast hash registers
+static esp_err_t dm9051_write(spi_device_handle_t device, const uint8_t *data) {
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; ret == ESP_OK && i < 8; i++) {
+		ret = dm9051_write_reg(device, DM9051_MAR + i, data[i]);
+	}
+
+	return ret;
+}
+
+static esp_err_t dm9051_read(spi_device_handle_t device, uint8_t *data) {
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; ret == ESP_OK && i < 8; i++) {
+		ret = dm9051_read_reg(device, DM9051_MAR + i, &data[i]);
+	}
+
+	return ret;
+}
+
+static const calibration_chip_t s_dm9051 = {
+	.check_id     = dm9051_check_id,
+	.write        = dm9051_write,
+	.read         = dm9051_read,
+	.pattern_size = 8,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051
+
+	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+// 2 bit opcode, then byte enables and register address in 14 bits
+static esp_err_t ksz8851_access(spi_device_handle_t device, uint8_t opcode,
+								uint32_t reg, uint16_t *value) {
+	uint32_t              byte_mask = 0x3 << (10 + (reg & 0x2));
+	spi_transaction_ext_t trans     = {
+		.base = {
+			.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR |
+					 SPI_TRANS_USE_RXDATA | SPI_TRANS_USE_TXDATA,
+			.cmd     = opcode,
+			.addr    = (reg << 2) | byte_mask,
+			.length  = 16,
+			.tx_data = {*value & 0xFF, *value >> 8},
+		},
+		.command_bits = 2,
+		.address_bits = 14,
+	};
+	esp_err_t ret = spi_device_polling_transmit(
+		device, (spi_transaction_t *)&trans);
+
+	if (opcode == KSZ8851_SPI_READ) {
+		*value = trans.base.rx_data[0] | (trans.base.rx_data[1] << 8);
+	}
+
+	return ret;
+}
+
+static esp_err_t ksz8851_check_id(spi_device_handle_t device) {
+	uint16_t  id  = 0;
+	esp_err_t ret =
+		ksz8851_access(device, KSZ8851_SPI_READ, KSZ8851_CIDER, &id);
+
+	if (ret == ESP_OK && (id & KSZ8851_CHIP_ID_MASK) != KSZ8851_CHIP_ID) {
+		ret = ESP_ERR_INVALID_RESPONSE;
+	}
+
+	return ret;
+}
+
+// MARL, MARM and MARH
+static esp_err_t ksz8851_write(spi_device_handle_t device,
+							   const uint8_t      *data) {
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; ret == ESP_OK && i < 3; i++) {
+		uint16_t value = data[i * 2] | (data[i * 2 + 1] << 8);
+
+		ret = ksz8851_access(device, KSZ8851_SPI_WRITE, KSZ8851_MARL + i * 2,
+							 &value);
+	}
+
+	return ret;
+}
+
+static esp_err_t ksz8851_read(spi_device_handle_t device, uint8_t *data) {
+	esp_err_t ret = ESP_OK;
+
+	for (int i = 0; ret == ESP_OK && i < 3; i++) {
+		uint16_t value = 0;
+
+		ret = ksz8851_access(device, KSZ8851_SPI_READ, KSZ8851_MARL + i * 2,
+							 &value);
+
+		data[i * 2]     = value & 0xFF;
+		data[i * 2 + 1] = value >> 8;
+	}
+
+	return ret;
+}
+
+static const calibration_chip_t s_ksz8851 = {
+	.check_id     = ksz8851_check_id,
+	.write        = ksz8851_write,
+	.read         = ksz8851_read,
+	.pattern_size = 6,
+};
+	#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+
+static const calibration_chip_t *calibration_get_chip(
+	ethernet_driver_spi_module_type_t type) {
+	switch (type) {
+	#if CONFIG_ETHERNET_DRIVER_USE_W5500
+		case ETHERNET_DRIVER_SPI_MODULE_W5500:
+			return &s_w5500;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051
+		case ETHERNET_DRIVER_SPI_MODULE_DM9051:
+			return &s_dm9051;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051
+	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+		case ETHERNET_DRIVER_SPI_MODULE_KSZ8851SNL:
+			return &s_ksz8851;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+		default:
+			return NULL;
+	}
+}
+
+/**
+ * Run the ID check and the pattern test at clock_speed_hz. Garbled writes
+ * at a failing clock may hit any register, which is fine as the MAC driver
+ * resets the chip when it is installed.
+ */
+static esp_err_t calibration_test(
+	const calibration_chip_t            *chip,
+	const ethernet_driver_spi_module_config_t *module_config,
+	const spi_device_interface_config_t *device_interface_config,
+	int                                  clock_speed_hz) {
+	spi_device_interface_config_t config = *device_interface_config;
+	spi_device_handle_t           device = NULL;
+	uint8_t pattern[CALIBRATION_PATTERN_SIZE_MAX];
+	uint8_t readback[CALIBRATION_PATTERN_SIZE_MAX];
+
+	config.clock_speed_hz = clock_speed_hz;
+	config.pre_cb         = NULL;
+	config.post_cb        = NULL;
+
+	esp_err_t ret =
+		spi_bus_add_device(module_config->spi_host, &config, &device);
+
+	for (int i = 0; ret == ESP_OK && i < CALIBRATION_ITERATIONS; i++) {
+		// Alternate 0xAA/0x55 so every data line toggles between bits
+		for (size_t j = 0; j < chip->pattern_size; j++) {
+			pattern[j] = ((i + j) & 1 ? 0x55 : 0xAA) ^ (uint8_t)(i * 31);
+		}
+
+		memset(readback, 0, sizeof(readback));
+
+		ret = chip->check_id(device);
+
+		if (ret == ESP_OK) {
+			ret = chip->write(device, pattern);
+		}
+
+		if (ret == ESP_OK) {
+			ret = chip->read(device, readback);
+		}
+
+		if (ret == ESP_OK &&
+			memcmp(pattern, readback, chip->pattern_size) != 0) {
+			ret = ESP_ERR_INVALID_RESPONSE;
+		}
+	}
+
+	if (device != NULL) {
+		spi_bus_remove_device(device);
+	}
+
+	return ret;
+}
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+		#define CALIBRATION_NVS_NAMESPACE "eth_driver"
+
+/** Cached result, only valid for the module it was measured on */
+typedef struct calibration_record_s {
+	uint8_t type;
+	uint8_t spi_host;
+	int8_t  spi_cs_gpio;
+	int32_t configured_clock_speed_hz;
+	int32_t clock_speed_hz;
+} calibration_record_t;
+
+static void calibration_key(uint32_t num, char *key, size_t size) {
+	snprintf(key, size, "spi_clk%" PRIu32, num);
+}
+
+static void calibration_record(
+	const ethernet_driver_spi_module_config_t *module_config,
+	int clock_speed_hz, calibration_record_t *record) {
+	memset(record, 0, sizeof(calibration_record_t));
+
+	record->type                      = module_config->type;
+	record->spi_host                  = module_config->spi_host;
+	record->spi_cs_gpio               = module_config->spi_cs_gpio;
+	record->configured_clock_speed_hz = module_config->clock_speed_hz;
+	record->clock_speed_hz            = clock_speed_hz;
+}
+
+static esp_err_t calibration_load(
+	uint32_t num, const ethernet_driver_spi_module_config_t *module_config,
+	int *clock_speed_hz) {
+	calibration_record_t stored;
+	calibration_record_t expected;
+	size_t               size = sizeof(stored);
+	nvs_handle_t         nvs;
+	char                 key[16];
+
+	calibration_key(num, key, sizeof(key));
+
+	esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READONLY, &nvs);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	ret = nvs_get_blob(nvs, key, &stored, &size);
+	nvs_close(nvs);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	calibration_record(module_config, stored.clock_speed_hz, &expected);
+
+	if (size != sizeof(stored) || memcmp(&stored, &expected, size) != 0) {
+		return ESP_ERR_INVALID_VERSION;
+	}
+
+	*clock_speed_hz = stored.clock_speed_hz;
+
+	return ESP_OK;
+}
+
+static void calibration_store(
+	uint32_t num, const ethernet_driver_spi_module_config_t *module_config,
+	int clock_speed_hz) {
+	calibration_record_t record;
+	nvs_handle_t         nvs;
+	char                 key[16];
+
+	calibration_key(num, key, sizeof(key));
+	calibration_record(module_config, clock_speed_hz, &record);
+
+	esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+
+	if (ret == ESP_OK) {
+		ret = nvs_set_blob(nvs, key, &record, sizeof(record));
+
+		if (ret == ESP_OK) {
+			ret = nvs_commit(nvs);
+		}
+
+		nvs_close(nvs);
+	}
+
+	if (ret != ESP_OK) {
+		LOGW("Could not cache SPI clock of module %" PRIu32 ": %s", num,
+			 esp_err_to_name(ret));
+	}
+}
+
+esp_err_t ethernet_driver_spi_calibration_erase(uint32_t num) {
+	nvs_handle_t nvs;
+	char         key[16];
+
+	calibration_key(num, key, sizeof(key));
+
+	esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+
+	if (ret != ESP_OK) {
+		return ret;
+	}
+
+	ret = nvs_erase_key(nvs, key);
+
+	if (ret == ESP_OK) {
+		ret = nvs_commit(nvs);
+	}
+
+	nvs_close(nvs);
+
+	return ret == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : ret;
+}
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+
+esp_err_t ethernet_driver_spi_calibrate(
+	uint32_t num, const ethernet_driver_spi_module_config_t *module_config,
+	const spi_device_interface_config_t *device_interface_config,
+	int                                 *clock_speed_hz) {
+	if (module_config == NULL || device_interface_config == NULL ||
+		clock_speed_hz == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	const calibration_chip_t *chip = calibration_get_chip(module_config->type);
+
+	if (chip == NULL) {
+		return ESP_ERR_NOT_SUPPORTED;
+	}
+
+	int clock = 0;
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+	// A cached clock still has to pass once, the board may have changed
+	if (calibration_load(num, module_config, &clock) == ESP_OK &&
+		calibration_test(chip, module_config, device_interface_config,
+						 clock) == ESP_OK) {
+		LOGI("SPI module %" PRIu32 " at cached %d Hz", num, clock);
+
+		*clock_speed_hz = clock;
+
+		return ESP_OK;
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+
+	int fastest = 0;
+
+	for (clock = module_config->clock_speed_hz; clock <= CALIBRATION_MAX_HZ;
+		 clock += CALIBRATION_STEP_HZ) {
+		if (calibration_test(chip, module_config, device_interface_config,
+							 clock) != ESP_OK) {
+			break;
+		}
+
+		fastest = clock;
+	}
+
+	if (fastest == 0) {
+		LOGE("SPI module %" PRIu32 " fails at the configured %d Hz", num,
+			 module_config->clock_speed_hz);
+
+		return ESP_ERR_INVALID_RESPONSE;
+	}
+
+	clock = fastest -
+			fastest / 100 *
+				CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_MARGIN_PERCENT;
+
+	if (clock < module_config->clock_speed_hz) {
+		clock = module_config->clock_speed_hz;
+	}
+
+	LOGI("SPI module %" PRIu32 " verified up to %d Hz, using %d Hz", num,
+		 fastest, clock);
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+	calibration_store(num, module_config, clock);
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+
+	*clock_speed_hz = clock;
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION
@@ -0,0 +1,244 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_stats.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+
+#include "log_utils.h"
+
+#include "ethernet_driver.h"
+#include "ethernet_driver_atomic.h"
+#include "ethernet_driver_stats.h"
+
+LOG_TAG("ethernet_driver_stats");
+
+typedef struct ethernet_driver_stats_block_s {
+	_Atomic uint32_t rx_frames;
+	_Atomic uint32_t rx_bytes;
+	_Atomic uint32_t rx_dropped;
+	_Atomic uint32_t tx_frames;
+	_Atomic uint32_t tx_bytes;
+	_Atomic uint32_t tx_dropped;
+	_Atomic uint32_t spi_transactions;
+	_Atomic uint32_t spi_time_us;
+	_Atomic uint32_t link_flaps;
+	_Atomic uint32_t spi_clock_hz;
+	_Atomic uint32_t rx_latency_us[ETHERNET_DRIVER_STATS_LATENCY_BUCKETS];
+	int64_t          spi_start_us;
+} ethernet_driver_stats_block_t;
+
+static ethernet_driver_stats_block_t s_stats[ETHERNET_DRIVER_ETHERNETS_NUM];
+
+esp_err_t ethernet_driver_get_stats(uint32_t                 index,
+									ethernet_driver_stats_t *stats) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	ethernet_driver_stats_block_t *block = &s_stats[index];
+
+	stats->rx_frames        = RELAXED_LOAD(block->rx_frames);
+	stats->rx_bytes         = RELAXED_LOAD(block->rx_bytes);
+	stats->rx_dropped       = RELAXED_LOAD(block->rx_dropped);
+	stats->tx_frames        = RELAXED_LOAD(block->tx_frames);
+	stats->tx_bytes         = RELAXED_LOAD(block->tx_bytes);
+	stats->tx_dropped       = RELAXED_LOAD(block->tx_dropped);
+	stats->spi_transactions = RELAXED_LOAD(block->spi_transactions);
+	stats->spi_time_us      = RELAXED_LOAD(block->spi_time_us);
+	stats->link_flaps       = RELAXED_LOAD(block->link_flaps);
+	stats->spi_clock_hz     = RELAXED_LOAD(block->spi_clock_hz);
+
+	for (int i = 0; i < ETHERNET_DRIVER_STATS_LATENCY_BUCKETS; i++) {
+		stats->rx_latency_us[i] = RELAXED_LOAD(block->rx_latency_us[i]);
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_reset_stats(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	ethernet_driver_stats_block_t *block = &s_stats[index];
+
+	RELAXED_CLEAR(block->rx_frames);
+	RELAXED_CLEAR(block->rx_bytes);
+	RELAXED_CLEAR(block->rx_dropped);
+	RELAXED_CLEAR(block->tx_frames);
+	RELAXED_CLEAR(block->tx_bytes);
+	RELAXED_CLEAR(block->tx_dropped);
+	RELAXED_CLEAR(block->spi_transactions);
+	RELAXED_CLEAR(block->spi_time_us);
+	RELAXED_CLEAR(block->link_flaps);
+
+	for (int i = 0; i < ETHERNET_DRIVER_STATS_LATENCY_BUCKETS; i++) {
+		RELAXED_CLEAR(block->rx_latency_us[i]);
+	}
+
+	return ESP_OK;
+}
+
+ethernet_driver_stats_handle_t ethernet_driver_stats_get_handle(
+	uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return NULL;
+	}
+
+	return &s_stats[index];
+}
+
+void ethernet_driver_stats_rx(ethernet_driver_stats_handle_t stats,
+							  uint32_t bytes, uint32_t latency_us) {
+	if (stats == NULL) {
+		return;
+	}
+
+	// Bucket i holds the latencies below 2^i us
+	uint32_t bucket = latency_us == 0 ? 0 : 32 - __builtin_clz(latency_us);
+
+	if (bucket >= ETHERNET_DRIVER_STATS_LATENCY_BUCKETS) {
+		bucket = ETHERNET_DRIVER_STATS_LATENCY_BUCKETS - 1;
+	}
+
+	RELAXED_ADD(stats->rx_frames, 1);
+	RELAXED_ADD(stats->rx_bytes, bytes);
+	RELAXED_ADD(stats->rx_latency_us[bucket], 1);
+}
+
+void ethernet_driver_stats_rx_dropped(ethernet_driver_stats_handle_t stats) {
+	if (stats != NULL) {
+		RELAXED_ADD(stats->rx_dropped, 1);
+	}
+}
+
+void ethernet_driver_stats_tx(ethernet_driver_stats_handle_t stats,
+							  uint32_t                       bytes) {
+	if (stats != NULL) {
+		RELAXED_ADD(stats->tx_frames, 1);
+		RELAXED_ADD(stats->tx_bytes, bytes);
+	}
+}
+
+void ethernet_driver_stats_tx_dropped(ethernet_driver_stats_handle_t stats) {
+	if (stats != NULL) {
+		RELAXED_ADD(stats->tx_dropped, 1);
+	}
+}
+
+void ethernet_driver_stats_link_flap(ethernet_driver_stats_handle_t stats) {
+	if (stats != NULL) {
+		RELAXED_ADD(stats->link_flaps, 1);
+	}
+}
+
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+// A module has one transaction in flight at a time, so one start stamp does
+static IRAM_ATTR void stats_spi_pre(ethernet_driver_stats_block_t *block) {
+	block->spi_start_us = esp_timer_get_time();
+}
+
+static IRAM_ATTR void stats_spi_post(ethernet_driver_stats_block_t *block) {
+	uint32_t duration_us =
+		(uint32_t)(esp_timer_get_time() - block->spi_start_us);
+
+	RELAXED_ADD(block->spi_transactions, 1);
+	RELAXED_ADD(block->spi_time_us, duration_us);
+
+	#if CONFIG_ETHERNET_DRIVER_TRACE_SPI
+	ethernet_driver_trace_write(block - s_stats,
+								ETHERNET_DRIVER_TRACE_SPI_TRANSACTION,
+								&duration_us, sizeof(duration_us));
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_SPI
+}
+
+	// The transaction callbacks carry no device, so each module gets its own
+	#define STATS_SPI_CALLBACKS(num)                                      \
+		static IRAM_ATTR void stats_spi_pre_##num(spi_transaction_t *t) {  \
+			stats_spi_pre(&s_stats[ETHERNET_DRIVER_SPI_INDEX(num)]);      \
+		}                                                                 \
+		static IRAM_ATTR void stats_spi_post_##num(spi_transaction_t *t) { \
+			stats_spi_post(&s_stats[ETHERNET_DRIVER_SPI_INDEX(num)]);     \
+		}
+
+STATS_SPI_CALLBACKS(0)
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 1
+STATS_SPI_CALLBACKS(1)
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 2
+STATS_SPI_CALLBACKS(2)
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 3
+STATS_SPI_CALLBACKS(3)
+	#endif
+
+static const transaction_cb_t s_spi_pre_cb[] = {
+	stats_spi_pre_0,
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 1
+	stats_spi_pre_1,
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 2
+	stats_spi_pre_2,
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 3
+	stats_spi_pre_3,
+	#endif
+};
+
+static const transaction_cb_t s_spi_post_cb[] = {
+	stats_spi_post_0,
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 1
+	stats_spi_post_1,
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 2
+	stats_spi_post_2,
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 3
+	stats_spi_post_3,
+	#endif
+};
+
+esp_err_t ethernet_driver_stats_hook_spi(
+	uint32_t num, spi_device_interface_config_t *device_interface_config) {
+	if (num >= CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM ||
+		device_interface_config == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	device_interface_config->pre_cb  = s_spi_pre_cb[num];
+	device_interface_config->post_cb = s_spi_post_cb[num];
+
+	// Not a counter, kept across ethernet_driver_reset_stats()
+	RELAXED_STORE(s_stats[ETHERNET_DRIVER_SPI_INDEX(num)].spi_clock_hz,
+				  device_interface_config->clock_speed_hz);
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
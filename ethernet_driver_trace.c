@@ -0,0 +1,256 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_trace.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_TRACE
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/semphr.h"
+	#include "freertos/task.h"
+
+	#include "esp_attr.h"
+	#include "esp_err.h"
+	#include "esp_netif.h"
+	#include "esp_timer.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_trace.h"
+
+LOG_TAG("ethernet_driver_trace");
+
+	#define TRACE_MASK       (ETHERNET_DRIVER_TRACE_RECORDS - 1)
+	#define TRACE_READ_CHUNK 8
+
+/** sequence is position + 1 once the record written at position is whole */
+typedef struct trace_slot_s {
+	_Atomic uint32_t               sequence;
+	ethernet_driver_trace_record_t record;
+} trace_slot_t;
+
+static trace_slot_t      s_slots[ETHERNET_DRIVER_TRACE_RECORDS];
+static _Atomic uint32_t  s_head;
+static uint32_t          s_tail; // Read position, guarded by s_read_lock
+static SemaphoreHandle_t s_read_lock;
+	#if CONFIG_ETHERNET_DRIVER_TRACE_TASK
+static TaskHandle_t s_task;
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_TASK
+
+static const char *const s_names[ETHERNET_DRIVER_TRACE_ID_MAX] = {
+	[ETHERNET_DRIVER_TRACE_START]           = "start",
+	[ETHERNET_DRIVER_TRACE_STOP]            = "stop",
+	[ETHERNET_DRIVER_TRACE_LINK_UP]         = "link up",
+	[ETHERNET_DRIVER_TRACE_LINK_DOWN]       = "link down",
+	[ETHERNET_DRIVER_TRACE_GOT_IP]          = "got IP",
+	[ETHERNET_DRIVER_TRACE_RX_BURST]        = "rx burst",
+	[ETHERNET_DRIVER_TRACE_TX_BURST]        = "tx burst",
+	[ETHERNET_DRIVER_TRACE_SPI_TRANSACTION] = "spi",
+};
+
+IRAM_ATTR void ethernet_driver_trace_write(uint32_t                   index,
+										   ethernet_driver_trace_id_t id,
+										   const void *data, size_t size) {
+	uint32_t      position = RELAXED_ADD(s_head, 1);
+	trace_slot_t *slot     = &s_slots[position & TRACE_MASK];
+
+	// Readers leave the slot alone until it is whole again
+	RELAXED_CLEAR(slot->sequence);
+	atomic_thread_fence(memory_order_release);
+
+	slot->record.timestamp_us = (uint32_t)esp_timer_get_time();
+	slot->record.index        = index;
+	slot->record.id           = id;
+
+	memset(&slot->record.data, 0, sizeof(slot->record.data));
+
+	if (data != NULL) {
+		memcpy(&slot->record.data, data,
+			   size < sizeof(slot->record.data) ? size
+												: sizeof(slot->record.data));
+	}
+
+	atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+}
+
+size_t ethernet_driver_trace_read(ethernet_driver_trace_record_t *records,
+								  size_t max, uint32_t *lost) {
+	size_t   count   = 0;
+	uint32_t skipped = 0;
+
+	if (records == NULL || s_read_lock == NULL) {
+		return 0;
+	}
+
+	xSemaphoreTake(s_read_lock, portMAX_DELAY);
+
+	uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+
+	// Overwritten before they could be read
+	if (head - s_tail > ETHERNET_DRIVER_TRACE_RECORDS) {
+		skipped += head - s_tail - ETHERNET_DRIVER_TRACE_RECORDS;
+		s_tail   = head - ETHERNET_DRIVER_TRACE_RECORDS;
+	}
+
+	while (count < max && s_tail != head) {
+		trace_slot_t *slot = &s_slots[s_tail & TRACE_MASK];
+		uint32_t      sequence =
+			atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		int32_t age = (int32_t)(sequence - (s_tail + 1));
+
+		// Still being written, read on the next call
+		if (sequence == 0 || age < 0) {
+			break;
+		}
+
+		if (age == 0) {
+			records[count] = slot->record;
+
+			// A writer that lapped the reader may have changed the copy
+			atomic_thread_fence(memory_order_acquire);
+
+			if (RELAXED_LOAD(slot->sequence) == sequence) {
+				count++;
+				s_tail++;
+				continue;
+			}
+		}
+
+		skipped++;
+		s_tail++;
+	}
+
+	xSemaphoreGive(s_read_lock);
+
+	if (lost != NULL) {
+		*lost += skipped;
+	}
+
+	return count;
+}
+
+void ethernet_driver_trace_print(const ethernet_driver_trace_record_t *record) {
+	const char *name = record->id < ETHERNET_DRIVER_TRACE_ID_MAX
+						 ? s_names[record->id]
+						 : "unknown";
+
+	switch (record->id) {
+		case ETHERNET_DRIVER_TRACE_LINK_UP:
+			LOGI("%10" PRIu32 " %u %s %02x:%02x:%02x:%02x:%02x:%02x",
+				 record->timestamp_us, record->index, name,
+				 record->data.mac[0], record->data.mac[1], record->data.mac[2],
+				 record->data.mac[3], record->data.mac[4],
+				 record->data.mac[5]);
+			break;
+		case ETHERNET_DRIVER_TRACE_GOT_IP: {
+			const esp_ip4_addr_t *ip = (const esp_ip4_addr_t *)record->data.ip;
+
+			LOGI("%10" PRIu32 " %u %s " IPSTR " mask " IPSTR " gw " IPSTR,
+				 record->timestamp_us, record->index, name, IP2STR(&ip[0]),
+				 IP2STR(&ip[1]), IP2STR(&ip[2]));
+			break;
+		}
+		case ETHERNET_DRIVER_TRACE_RX_BURST:
+		case ETHERNET_DRIVER_TRACE_TX_BURST:
+			LOGI("%10" PRIu32 " %u %s %" PRIu32 " frames",
+				 record->timestamp_us, record->index, name,
+				 record->data.value);
+			break;
+		case ETHERNET_DRIVER_TRACE_SPI_TRANSACTION:
+			LOGI("%10" PRIu32 " %u %s %" PRIu32 " us", record->timestamp_us,
+				 record->index, name, record->data.value);
+			break;
+		default:
+			LOGI("%10" PRIu32 " %u %s", record->timestamp_us, record->index,
+				 name);
+			break;
+	}
+}
+
+void ethernet_driver_trace_dump(void) {
+	ethernet_driver_trace_record_t records[TRACE_READ_CHUNK];
+	uint32_t                       lost  = 0;
+	size_t                         count = 0;
+
+	// Bounded, writers may be faster than the log
+	for (size_t total = 0; total < ETHERNET_DRIVER_TRACE_RECORDS;
+		 total += count) {
+		count = ethernet_driver_trace_read(records, TRACE_READ_CHUNK, &lost);
+
+		if (count == 0) {
+			break;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			ethernet_driver_trace_print(&records[i]);
+		}
+	}
+
+	if (lost > 0) {
+		LOGW("%" PRIu32 " trace records lost", lost);
+	}
+}
+
+	#if CONFIG_ETHERNET_DRIVER_TRACE_TASK
+static void trace_task(void *arg) {
+	for (;;) {
+		vTaskDelay(pdMS_TO_TICKS(CONFIG_ETHERNET_DRIVER_TRACE_TASK_PERIOD_MS));
+		ethernet_driver_trace_dump();
+	}
+}
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_TASK
+
+esp_err_t ethernet_driver_trace_init(void) {
+	if (s_read_lock == NULL) {
+		s_read_lock = xSemaphoreCreateMutex();
+
+		if (s_read_lock == NULL) {
+			LOGE("No memory for the trace lock");
+
+			return ESP_ERR_NO_MEM;
+		}
+	}
+
+	#if CONFIG_ETHERNET_DRIVER_TRACE_TASK
+	if (s_task == NULL &&
+		xTaskCreate(trace_task, "eth_trace",
+					CONFIG_ETHERNET_DRIVER_TRACE_TASK_STACK_SIZE, NULL,
+					CONFIG_ETHERNET_DRIVER_TRACE_TASK_PRIO,
+					&s_task) != pdPASS) {
+		LOGE("Could not create trace task");
+
+		return ESP_ERR_NO_MEM;
+	}
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_TASK
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_TRACE
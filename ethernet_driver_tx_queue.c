@@ -0,0 +1,305 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_tx_queue.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/queue.h"
+	#include "freertos/semphr.h"
+	#include "freertos/task.h"
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_netstack.h"
+	#include "ethernet_driver_stats.h"
+	#include "ethernet_driver_tx_queue.h"
+
+LOG_TAG("ethernet_driver_tx_queue");
+
+typedef struct tx_queue_entry_s {
+	void  *buffer;
+	size_t length;
+	void  *netstack_buffer;
+} tx_queue_entry_t;
+
+/**
+ * Frames wait in queue for the TX task, which sends everything queued at
+ * each wake-up back to back. credits holds one token per free slot below
+ * the current depth.
+ */
+typedef struct ethernet_driver_tx_queue_s {
+	esp_eth_handle_t               eth_handle;
+	uint32_t                       num;
+	ethernet_driver_stats_handle_t stats;
+	QueueHandle_t                  queue;
+	SemaphoreHandle_t              credits;
+	TaskHandle_t                   task;
+	TaskHandle_t                   deleter;
+	_Atomic uint32_t               depth;
+	_Atomic uint32_t               queued_frames;
+	_Atomic uint32_t               bursts;
+	_Atomic uint32_t               max_burst;
+	_Atomic uint32_t               full_waits;
+	_Atomic uint32_t               copied_frames;
+} ethernet_driver_tx_queue_t;
+
+static ethernet_driver_tx_queue_t
+	*s_tx_queues[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
+
+static ethernet_driver_tx_queue_t *tx_queue_from_index(uint32_t index) {
+	if (index < ETHERNET_DRIVER_SPI_INDEX(0) ||
+		index >= ETHERNET_DRIVER_SPI_INDEX(
+					 CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM)) {
+		return NULL;
+	}
+
+	return s_tx_queues[index - ETHERNET_DRIVER_SPI_INDEX(0)];
+}
+
+static void tx_queue_transmit(ethernet_driver_tx_queue_t *tx_queue,
+							  tx_queue_entry_t           *entry) {
+	if (esp_eth_transmit(tx_queue->eth_handle, entry->buffer,
+						 entry->length) == ESP_OK) {
+		ethernet_driver_stats_tx(tx_queue->stats, entry->length);
+	} else {
+		ethernet_driver_stats_tx_dropped(tx_queue->stats);
+	}
+
+	if (entry->netstack_buffer != NULL) {
+		ethernet_driver_netstack_tx_unref(entry->netstack_buffer);
+	} else {
+		free(entry->buffer);
+	}
+
+	xSemaphoreGive(tx_queue->credits);
+}
+
+static void tx_queue_task(void *arg) {
+	ethernet_driver_tx_queue_t *tx_queue = arg;
+	tx_queue_entry_t            entry;
+
+	for (;;) {
+		xQueueReceive(tx_queue->queue, &entry, portMAX_DELAY);
+
+		uint32_t burst = 0;
+
+		do {
+			// Queued by ethernet_driver_tx_queue_del() behind the last frame
+			if (entry.buffer == NULL) {
+				xTaskNotifyGive(tx_queue->deleter);
+				vTaskDelete(NULL);
+			}
+
+			tx_queue_transmit(tx_queue, &entry);
+			burst++;
+		} while (xQueueReceive(tx_queue->queue, &entry, 0) == pdTRUE);
+
+		RELAXED_ADD(tx_queue->bursts, 1);
+
+	#if CONFIG_ETHERNET_DRIVER_TRACE_BURSTS
+		ethernet_driver_trace_write(ETHERNET_DRIVER_SPI_INDEX(tx_queue->num),
+									ETHERNET_DRIVER_TRACE_TX_BURST, &burst,
+									sizeof(burst));
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_BURSTS
+
+		// Only this task writes max_burst
+		if (burst > RELAXED_LOAD(tx_queue->max_burst)) {
+			RELAXED_STORE(tx_queue->max_burst, burst);
+		}
+	}
+}
+
+esp_err_t ethernet_driver_tx_queue_send(
+	ethernet_driver_tx_queue_handle_t tx_queue, void *buffer, size_t length,
+	void *netstack_buffer) {
+	if (tx_queue == NULL || buffer == NULL || length == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	tx_queue_entry_t entry = {
+		.buffer          = buffer,
+		.length          = length,
+		.netstack_buffer = netstack_buffer,
+	};
+
+	if (netstack_buffer == NULL) {
+		entry.buffer = malloc(length);
+
+		if (entry.buffer == NULL) {
+			return ESP_ERR_NO_MEM;
+		}
+
+		memcpy(entry.buffer, buffer, length);
+		RELAXED_ADD(tx_queue->copied_frames, 1);
+	} else {
+		ethernet_driver_netstack_tx_ref(netstack_buffer);
+	}
+
+	if (xSemaphoreTake(tx_queue->credits, 0) != pdTRUE) {
+		// Back pressure on the stack instead of dropping or reordering
+		RELAXED_ADD(tx_queue->full_waits, 1);
+		xSemaphoreTake(tx_queue->credits, portMAX_DELAY);
+	}
+
+	// A credit guarantees a free slot
+	xQueueSend(tx_queue->queue, &entry, 0);
+	RELAXED_ADD(tx_queue->queued_frames, 1);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_queue_set_depth(uint32_t index, uint32_t depth) {
+	ethernet_driver_tx_queue_t *tx_queue = tx_queue_from_index(index);
+
+	if (tx_queue == NULL || depth == 0 ||
+		depth > CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_MAX_DEPTH) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	// Concurrent callers each settle the difference to the depth they saw
+	uint32_t previous = atomic_exchange(&tx_queue->depth, depth);
+
+	for (uint32_t i = previous; i < depth; i++) {
+		xSemaphoreGive(tx_queue->credits);
+	}
+
+	for (uint32_t i = depth; i < previous; i++) {
+		xSemaphoreTake(tx_queue->credits, portMAX_DELAY);
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_queue_get_stats(
+	uint32_t index, ethernet_driver_tx_queue_stats_t *stats) {
+	ethernet_driver_tx_queue_t *tx_queue = tx_queue_from_index(index);
+
+	if (tx_queue == NULL || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	stats->depth         = RELAXED_LOAD(tx_queue->depth);
+	stats->queued_frames = RELAXED_LOAD(tx_queue->queued_frames);
+	stats->bursts        = RELAXED_LOAD(tx_queue->bursts);
+	stats->max_burst     = RELAXED_LOAD(tx_queue->max_burst);
+	stats->full_waits    = RELAXED_LOAD(tx_queue->full_waits);
+	stats->copied_frames = RELAXED_LOAD(tx_queue->copied_frames);
+
+	return ESP_OK;
+}
+
+ethernet_driver_tx_queue_handle_t ethernet_driver_tx_queue_new(
+	esp_eth_handle_t eth_handle, uint32_t index) {
+	if (eth_handle == NULL || index < ETHERNET_DRIVER_SPI_INDEX(0) ||
+		index >= ETHERNET_DRIVER_SPI_INDEX(
+					 CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM)) {
+		LOGE("Invalid TX queue interface");
+
+		return NULL;
+	}
+
+	uint32_t depth = CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_DEPTH;
+
+	if (depth > CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_MAX_DEPTH) {
+		depth = CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_MAX_DEPTH;
+	}
+
+	ethernet_driver_tx_queue_t *tx_queue = calloc(1, sizeof(*tx_queue));
+
+	if (tx_queue == NULL) {
+		LOGE("No memory for TX queue");
+
+		return NULL;
+	}
+
+	tx_queue->eth_handle = eth_handle;
+	tx_queue->num        = index - ETHERNET_DRIVER_SPI_INDEX(0);
+	tx_queue->stats      = ethernet_driver_stats_get_handle(index);
+	tx_queue->depth      = depth;
+
+	// One slot more for the end marker of ethernet_driver_tx_queue_del()
+	tx_queue->queue = xQueueCreate(
+		CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_MAX_DEPTH + 1,
+		sizeof(tx_queue_entry_t));
+	tx_queue->credits = xSemaphoreCreateCounting(
+		CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_MAX_DEPTH, depth);
+
+	if (tx_queue->queue == NULL || tx_queue->credits == NULL ||
+		xTaskCreate(tx_queue_task, "eth_tx_queue",
+					CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_TASK_STACK_SIZE,
+					tx_queue, CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_TASK_PRIO,
+					&tx_queue->task) != pdPASS) {
+		LOGE("No memory for TX queue");
+
+		if (tx_queue->queue != NULL) {
+			vQueueDelete(tx_queue->queue);
+		}
+
+		if (tx_queue->credits != NULL) {
+			vSemaphoreDelete(tx_queue->credits);
+		}
+
+		free(tx_queue);
+
+		return NULL;
+	}
+
+	s_tx_queues[tx_queue->num] = tx_queue;
+
+	return tx_queue;
+}
+
+esp_err_t ethernet_driver_tx_queue_del(
+	ethernet_driver_tx_queue_handle_t tx_queue) {
+	if (tx_queue == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	tx_queue_entry_t end = {0};
+
+	// Frames already queued are still sent
+	tx_queue->deleter = xTaskGetCurrentTaskHandle();
+	xQueueSend(tx_queue->queue, &end, portMAX_DELAY);
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	s_tx_queues[tx_queue->num] = NULL;
+
+	vQueueDelete(tx_queue->queue);
+	vSemaphoreDelete(tx_queue->credits);
+	free(tx_queue);
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
@@ -0,0 +1,597 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_tx_sched.c
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+
+	#include "freertos/FreeRTOS.h"
+	#include "freertos/queue.h"
+	#include "freertos/task.h"
+
+	#include "esp_err.h"
+	#include "esp_eth.h"
+	#include "esp_timer.h"
+
+	#include "log_utils.h"
+
+	#include "ethernet_driver.h"
+	#include "ethernet_driver_atomic.h"
+	#include "ethernet_driver_netstack.h"
+	#include "ethernet_driver_stats.h"
+	#include "ethernet_driver_tx_sched.h"
+
+LOG_TAG("ethernet_driver_tx_sched");
+
+	#define TX_SCHED_ETH_TYPE_VLAN 0x8100
+	#define TX_SCHED_ETH_TYPE_IPV4 0x0800
+	#define TX_SCHED_ETH_TYPE_ARP  0x0806
+	#define TX_SCHED_ETH_TYPE_IPV6 0x86DD
+	#define TX_SCHED_DSCP_LE       1
+	#define TX_SCHED_DSCP_CS1      8
+	#define TX_SCHED_DSCP_CS5      40
+	#define TX_SCHED_PCP_BK        1
+	#define TX_SCHED_PCP_VI        5
+
+// Burst the bulk queue may send at line rate after being idle
+	#define TX_SCHED_BULK_BUCKET_BYTES (4 * ETH_MAX_PACKET_SIZE)
+
+typedef struct tx_sched_entry_s {
+	void   *buffer;
+	size_t  length;
+	void   *netstack_buffer;
+	int64_t queued_us;
+} tx_sched_entry_t;
+
+typedef struct tx_sched_queue_s {
+	QueueHandle_t    queue;
+	_Atomic uint32_t depth;
+	_Atomic uint32_t pending;
+	_Atomic uint32_t sent_frames;
+	_Atomic uint32_t sent_bytes;
+	_Atomic uint32_t dropped;
+	_Atomic uint32_t max_latency_us;
+	_Atomic uint32_t latency_us[ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS];
+} tx_sched_queue_t;
+
+/**
+ * Senders classify frames into queues and wake the TX task, which always
+ * sends from the first non-empty queue. The bulk queue is a token bucket
+ * in millibits, refilled by the task only.
+ */
+typedef struct ethernet_driver_tx_sched_s {
+	esp_eth_handle_t               eth_handle;
+	uint32_t                       index;
+	ethernet_driver_stats_handle_t stats;
+	TaskHandle_t                   task;
+	TaskHandle_t                   deleter;
+	uint8_t                        dscp_map[64];
+	uint8_t                        pcp_map[8];
+	_Atomic uint32_t               bulk_rate_kbps;
+	uint32_t                       bulk_rate_applied; // Task side copy
+	int64_t                        bulk_credit;
+	int64_t                        bulk_refill_us;
+	_Atomic uint32_t               throttled;
+	_Atomic uint32_t               bursts;
+	_Atomic uint32_t               max_burst;
+	_Atomic uint32_t               copied_frames;
+	tx_sched_queue_t               queues[ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM];
+} ethernet_driver_tx_sched_t;
+
+static ethernet_driver_tx_sched_t
+	*s_tx_scheds[ETHERNET_DRIVER_ETHERNETS_NUM];
+
+static uint32_t tx_sched_classify(ethernet_driver_tx_sched_t *tx_sched,
+								  const uint8_t *frame, size_t length) {
+	if (length < ETH_HEADER_LEN + 2) {
+		return ETHERNET_DRIVER_TX_SCHED_DEFAULT;
+	}
+
+	const uint8_t *payload   = frame + ETH_HEADER_LEN;
+	uint32_t       ethertype = (frame[12] << 8) | frame[13];
+
+	switch (ethertype) {
+		case TX_SCHED_ETH_TYPE_VLAN:
+			return tx_sched->pcp_map[payload[0] >> 5];
+		case TX_SCHED_ETH_TYPE_IPV4:
+			return tx_sched->dscp_map[payload[1] >> 2];
+		case TX_SCHED_ETH_TYPE_IPV6:
+			// Traffic class spans the two first bytes
+			return tx_sched
+				->dscp_map[((payload[0] & 0x0F) << 2) | (payload[1] >> 6)];
+		case TX_SCHED_ETH_TYPE_ARP:
+			// Control frames to a new peer wait for its resolution
+			return ETHERNET_DRIVER_TX_SCHED_CONTROL;
+		default:
+			return ETHERNET_DRIVER_TX_SCHED_DEFAULT;
+	}
+}
+
+static void tx_sched_release(ethernet_driver_tx_sched_t *tx_sched,
+							 tx_sched_entry_t           *entry) {
+	if (entry->netstack_buffer != NULL) {
+		ethernet_driver_netstack_tx_unref(entry->netstack_buffer);
+	} else {
+		free(entry->buffer);
+	}
+}
+
+static void tx_sched_transmit(ethernet_driver_tx_sched_t *tx_sched,
+							  tx_sched_queue_t           *queue,
+							  tx_sched_entry_t           *entry) {
+	if (esp_eth_transmit(tx_sched->eth_handle, entry->buffer,
+						 entry->length) == ESP_OK) {
+		ethernet_driver_stats_tx(tx_sched->stats, entry->length);
+		RELAXED_ADD(queue->sent_frames, 1);
+		RELAXED_ADD(queue->sent_bytes, entry->length);
+	} else {
+		ethernet_driver_stats_tx_dropped(tx_sched->stats);
+	}
+
+	uint32_t latency = esp_timer_get_time() - entry->queued_us;
+	uint32_t bucket  = 0;
+
+	while (bucket < ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS - 1 &&
+		   latency >= (32U << bucket)) {
+		bucket++;
+	}
+
+	RELAXED_ADD(queue->latency_us[bucket], 1);
+
+	// Only this task writes max_latency_us
+	if (latency > RELAXED_LOAD(queue->max_latency_us)) {
+		RELAXED_STORE(queue->max_latency_us, latency);
+	}
+
+	tx_sched_release(tx_sched, entry);
+}
+
+/**
+ * Whether the frame at the head of the bulk queue fits the token bucket,
+ * otherwise *wait is set to the time until it does.
+ */
+static bool tx_sched_bulk_ready(ethernet_driver_tx_sched_t *tx_sched,
+								TickType_t                 *wait) {
+	tx_sched_queue_t *queue = &tx_sched->queues[ETHERNET_DRIVER_TX_SCHED_BULK];
+	uint32_t          rate  = RELAXED_LOAD(tx_sched->bulk_rate_kbps);
+	int64_t           now   = esp_timer_get_time();
+	tx_sched_entry_t  entry;
+
+	// A new rate starts without the debt of the previous one
+	if (rate != tx_sched->bulk_rate_applied) {
+		tx_sched->bulk_rate_applied = rate;
+
+		if (tx_sched->bulk_credit < 0) {
+			tx_sched->bulk_credit = 0;
+		}
+	}
+
+	// kbit/s times us is millibits
+	tx_sched->bulk_credit += (now - tx_sched->bulk_refill_us) * rate;
+	tx_sched->bulk_refill_us = now;
+
+	if (tx_sched->bulk_credit > TX_SCHED_BULK_BUCKET_BYTES * 8000LL) {
+		tx_sched->bulk_credit = TX_SCHED_BULK_BUCKET_BYTES * 8000LL;
+	}
+
+	if (rate == 0 || xQueuePeek(queue->queue, &entry, 0) != pdTRUE) {
+		return true;
+	}
+
+	int64_t missing = entry.length * 8000LL - tx_sched->bulk_credit;
+
+	if (missing <= 0) {
+		return true;
+	}
+
+	RELAXED_ADD(tx_sched->throttled, 1);
+	*wait = pdMS_TO_TICKS(missing / rate / 1000) + 1;
+
+	return false;
+}
+
+static bool tx_sched_next(ethernet_driver_tx_sched_t *tx_sched,
+						  tx_sched_entry_t *entry, tx_sched_queue_t **queue,
+						  TickType_t *wait) {
+	*wait = portMAX_DELAY;
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		*queue = &tx_sched->queues[i];
+
+		if (i == ETHERNET_DRIVER_TX_SCHED_BULK &&
+			!tx_sched_bulk_ready(tx_sched, wait)) {
+			return false;
+		}
+
+		if (xQueueReceive((*queue)->queue, entry, 0) == pdTRUE) {
+			// Uncapped frames are not charged, nothing would refill it
+			if (i == ETHERNET_DRIVER_TX_SCHED_BULK &&
+				tx_sched->bulk_rate_applied != 0) {
+				tx_sched->bulk_credit -= entry->length * 8000LL;
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Drop what is left once ethernet_driver_tx_sched_del() queued its marker
+static void tx_sched_flush(ethernet_driver_tx_sched_t *tx_sched) {
+	tx_sched_entry_t entry;
+
+	for (uint32_t i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		tx_sched_queue_t *queue = &tx_sched->queues[i];
+
+		while (xQueueReceive(queue->queue, &entry, 0) == pdTRUE) {
+			RELAXED_ADD(queue->dropped, 1);
+			tx_sched_release(tx_sched, &entry);
+		}
+	}
+}
+
+static void tx_sched_task(void *arg) {
+	ethernet_driver_tx_sched_t *tx_sched = arg;
+	tx_sched_queue_t           *queue    = NULL;
+	TickType_t                  wait     = portMAX_DELAY;
+	tx_sched_entry_t            entry;
+
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, wait);
+
+		uint32_t burst = 0;
+
+		while (tx_sched_next(tx_sched, &entry, &queue, &wait)) {
+			// Queued by ethernet_driver_tx_sched_del() on the first queue
+			if (entry.buffer == NULL) {
+				tx_sched_flush(tx_sched);
+				xTaskNotifyGive(tx_sched->deleter);
+				vTaskDelete(NULL);
+			}
+
+			RELAXED_SUB(queue->pending, 1);
+			tx_sched_transmit(tx_sched, queue, &entry);
+			burst++;
+		}
+
+		if (burst == 0) {
+			continue;
+		}
+
+		RELAXED_ADD(tx_sched->bursts, 1);
+
+	#if CONFIG_ETHERNET_DRIVER_TRACE_BURSTS
+		ethernet_driver_trace_write(tx_sched->index,
+									ETHERNET_DRIVER_TRACE_TX_BURST, &burst,
+									sizeof(burst));
+	#endif // CONFIG_ETHERNET_DRIVER_TRACE_BURSTS
+
+		// Only this task writes max_burst
+		if (burst > RELAXED_LOAD(tx_sched->max_burst)) {
+			RELAXED_STORE(tx_sched->max_burst, burst);
+		}
+	}
+}
+
+esp_err_t ethernet_driver_tx_sched_send(
+	ethernet_driver_tx_sched_handle_t tx_sched, void *buffer, size_t length,
+	void *netstack_buffer) {
+	if (tx_sched == NULL || buffer == NULL || length == 0) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	tx_sched_queue_t *queue =
+		&tx_sched->queues[tx_sched_classify(tx_sched, buffer, length)];
+
+	// Reserving the slot first keeps concurrent senders within the depth
+	if (RELAXED_ADD(queue->pending, 1) >= RELAXED_LOAD(queue->depth)) {
+		RELAXED_SUB(queue->pending, 1);
+		RELAXED_ADD(queue->dropped, 1);
+
+		return ESP_ERR_NO_MEM;
+	}
+
+	tx_sched_entry_t entry = {
+		.buffer          = buffer,
+		.length          = length,
+		.netstack_buffer = netstack_buffer,
+		.queued_us       = esp_timer_get_time(),
+	};
+
+	if (netstack_buffer == NULL) {
+		entry.buffer = malloc(length);
+
+		if (entry.buffer == NULL) {
+			RELAXED_SUB(queue->pending, 1);
+
+			return ESP_ERR_NO_MEM;
+		}
+
+		memcpy(entry.buffer, buffer, length);
+		RELAXED_ADD(tx_sched->copied_frames, 1);
+	} else {
+		ethernet_driver_netstack_tx_ref(netstack_buffer);
+	}
+
+	// A reserved slot guarantees room in the queue
+	xQueueSend(queue->queue, &entry, 0);
+	xTaskNotifyGive(tx_sched->task);
+
+	return ESP_OK;
+}
+
+static ethernet_driver_tx_sched_t *tx_sched_from_index(uint32_t index) {
+	if (index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		return NULL;
+	}
+
+	return s_tx_scheds[index];
+}
+
+ethernet_driver_tx_sched_handle_t ethernet_driver_tx_sched_get(
+	uint32_t index) {
+	return tx_sched_from_index(index);
+}
+
+esp_err_t ethernet_driver_tx_sched_map_dscp(uint32_t index, uint8_t dscp,
+											uint32_t queue) {
+	ethernet_driver_tx_sched_t *tx_sched = tx_sched_from_index(index);
+
+	if (tx_sched == NULL || dscp >= sizeof(tx_sched->dscp_map) ||
+		queue >= ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	tx_sched->dscp_map[dscp] = queue;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_sched_map_pcp(uint32_t index, uint8_t pcp,
+										   uint32_t queue) {
+	ethernet_driver_tx_sched_t *tx_sched = tx_sched_from_index(index);
+
+	if (tx_sched == NULL || pcp >= sizeof(tx_sched->pcp_map) ||
+		queue >= ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	tx_sched->pcp_map[pcp] = queue;
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_sched_set_depth(uint32_t index, uint32_t queue,
+											 uint32_t depth) {
+	ethernet_driver_tx_sched_t *tx_sched = tx_sched_from_index(index);
+
+	if (tx_sched == NULL || queue >= ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM ||
+		depth == 0 || depth > CONFIG_ETHERNET_DRIVER_TX_SCHED_MAX_DEPTH) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	// Frames above a lowered depth are still sent
+	RELAXED_STORE(tx_sched->queues[queue].depth, depth);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_sched_set_bulk_rate(uint32_t index,
+												 uint32_t rate_kbps) {
+	ethernet_driver_tx_sched_t *tx_sched = tx_sched_from_index(index);
+
+	if (tx_sched == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	RELAXED_STORE(tx_sched->bulk_rate_kbps, rate_kbps);
+	// Let a waiting task take the new rate into account
+	xTaskNotifyGive(tx_sched->task);
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_sched_get_stats(
+	uint32_t index, ethernet_driver_tx_sched_stats_t *stats) {
+	ethernet_driver_tx_sched_t *tx_sched = tx_sched_from_index(index);
+
+	if (tx_sched == NULL || stats == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	stats->bulk_rate_kbps = RELAXED_LOAD(tx_sched->bulk_rate_kbps);
+	stats->throttled      = RELAXED_LOAD(tx_sched->throttled);
+	stats->bursts         = RELAXED_LOAD(tx_sched->bursts);
+	stats->max_burst      = RELAXED_LOAD(tx_sched->max_burst);
+	stats->copied_frames  = RELAXED_LOAD(tx_sched->copied_frames);
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		tx_sched_queue_t                       *queue = &tx_sched->queues[i];
+		ethernet_driver_tx_sched_queue_stats_t *queue_stats =
+			&stats->queues[i];
+
+		queue_stats->depth          = RELAXED_LOAD(queue->depth);
+		queue_stats->pending        = RELAXED_LOAD(queue->pending);
+		queue_stats->sent_frames    = RELAXED_LOAD(queue->sent_frames);
+		queue_stats->sent_bytes     = RELAXED_LOAD(queue->sent_bytes);
+		queue_stats->dropped        = RELAXED_LOAD(queue->dropped);
+		queue_stats->max_latency_us = RELAXED_LOAD(queue->max_latency_us);
+
+		for (int j = 0; j < ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS; j++) {
+			queue_stats->latency_us[j] = RELAXED_LOAD(queue->latency_us[j]);
+		}
+	}
+
+	return ESP_OK;
+}
+
+esp_err_t ethernet_driver_tx_sched_reset_stats(uint32_t index) {
+	ethernet_driver_tx_sched_t *tx_sched = tx_sched_from_index(index);
+
+	if (tx_sched == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	RELAXED_STORE(tx_sched->throttled, 0);
+	RELAXED_STORE(tx_sched->bursts, 0);
+	RELAXED_STORE(tx_sched->max_burst, 0);
+	RELAXED_STORE(tx_sched->copied_frames, 0);
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		tx_sched_queue_t *queue = &tx_sched->queues[i];
+
+		RELAXED_STORE(queue->sent_frames, 0);
+		RELAXED_STORE(queue->sent_bytes, 0);
+		RELAXED_STORE(queue->dropped, 0);
+		RELAXED_STORE(queue->max_latency_us, 0);
+
+		for (int j = 0; j < ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS; j++) {
+			RELAXED_STORE(queue->latency_us[j], 0);
+		}
+	}
+
+	return ESP_OK;
+}
+
+static void tx_sched_default_map(ethernet_driver_tx_sched_t *tx_sched) {
+	memset(tx_sched->dscp_map, ETHERNET_DRIVER_TX_SCHED_DEFAULT,
+		   sizeof(tx_sched->dscp_map));
+	memset(tx_sched->pcp_map, ETHERNET_DRIVER_TX_SCHED_DEFAULT,
+		   sizeof(tx_sched->pcp_map));
+
+	// CS5 to CS7 with EF and the voice admit codes in between
+	for (int dscp = TX_SCHED_DSCP_CS5; dscp < 64; dscp++) {
+		tx_sched->dscp_map[dscp] = ETHERNET_DRIVER_TX_SCHED_CONTROL;
+	}
+
+	for (int pcp = TX_SCHED_PCP_VI; pcp < 8; pcp++) {
+		tx_sched->pcp_map[pcp] = ETHERNET_DRIVER_TX_SCHED_CONTROL;
+	}
+
+	tx_sched->dscp_map[TX_SCHED_DSCP_LE]  = ETHERNET_DRIVER_TX_SCHED_BULK;
+	tx_sched->dscp_map[TX_SCHED_DSCP_CS1] = ETHERNET_DRIVER_TX_SCHED_BULK;
+	tx_sched->pcp_map[TX_SCHED_PCP_BK]    = ETHERNET_DRIVER_TX_SCHED_BULK;
+}
+
+static void tx_sched_free(ethernet_driver_tx_sched_t *tx_sched) {
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		if (tx_sched->queues[i].queue != NULL) {
+			vQueueDelete(tx_sched->queues[i].queue);
+		}
+	}
+
+	free(tx_sched);
+}
+
+ethernet_driver_tx_sched_handle_t ethernet_driver_tx_sched_new(
+	esp_eth_handle_t eth_handle, uint32_t index) {
+	if (eth_handle == NULL || index >= ETHERNET_DRIVER_ETHERNETS_NUM) {
+		LOGE("Invalid TX scheduler interface");
+
+		return NULL;
+	}
+
+	uint32_t depth = CONFIG_ETHERNET_DRIVER_TX_SCHED_DEPTH;
+
+	if (depth > CONFIG_ETHERNET_DRIVER_TX_SCHED_MAX_DEPTH) {
+		depth = CONFIG_ETHERNET_DRIVER_TX_SCHED_MAX_DEPTH;
+	}
+
+	ethernet_driver_tx_sched_t *tx_sched = calloc(1, sizeof(*tx_sched));
+
+	if (tx_sched == NULL) {
+		LOGE("No memory for TX scheduler");
+
+		return NULL;
+	}
+
+	tx_sched->eth_handle     = eth_handle;
+	tx_sched->index          = index;
+	tx_sched->stats          = ethernet_driver_stats_get_handle(index);
+	tx_sched->bulk_rate_kbps = CONFIG_ETHERNET_DRIVER_TX_SCHED_BULK_RATE_KBPS;
+	tx_sched->bulk_rate_applied =
+		CONFIG_ETHERNET_DRIVER_TX_SCHED_BULK_RATE_KBPS;
+	tx_sched->bulk_refill_us = esp_timer_get_time();
+
+	tx_sched_default_map(tx_sched);
+
+	for (int i = 0; i < ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM; i++) {
+		tx_sched_queue_t *queue = &tx_sched->queues[i];
+
+		queue->depth = depth;
+		// One slot more on the first queue for the end marker
+		queue->queue = xQueueCreate(
+			CONFIG_ETHERNET_DRIVER_TX_SCHED_MAX_DEPTH + (i == 0),
+			sizeof(tx_sched_entry_t));
+
+		if (queue->queue == NULL) {
+			LOGE("No memory for TX scheduler");
+			tx_sched_free(tx_sched);
+
+			return NULL;
+		}
+	}
+
+	if (xTaskCreate(tx_sched_task, "eth_tx_sched",
+					CONFIG_ETHERNET_DRIVER_TX_SCHED_TASK_STACK_SIZE, tx_sched,
+					CONFIG_ETHERNET_DRIVER_TX_SCHED_TASK_PRIO,
+					&tx_sched->task) != pdPASS) {
+		LOGE("No memory for TX scheduler");
+		tx_sched_free(tx_sched);
+
+		return NULL;
+	}
+
+	s_tx_scheds[index] = tx_sched;
+
+	return tx_sched;
+}
+
+esp_err_t ethernet_driver_tx_sched_del(
+	ethernet_driver_tx_sched_handle_t tx_sched) {
+	if (tx_sched == NULL) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	tx_sched_entry_t end = {0};
+
+	// Frames queued on the first queue before it are still sent
+	tx_sched->deleter = xTaskGetCurrentTaskHandle();
+	xQueueSend(tx_sched->queues[0].queue, &end, portMAX_DELAY);
+	xTaskNotifyGive(tx_sched->task);
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	s_tx_scheds[tx_sched->index] = NULL;
+
+	tx_sched_free(tx_sched);
+
+	return ESP_OK;
+}
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
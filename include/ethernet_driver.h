@@ -52,144 +52,267 @@
 
 #include "sdkconfig.h"
 
+#include "ethernet_driver_boot.h"
+#include "ethernet_driver_capture.h"
+#include "ethernet_driver_chksum.h"
+#include "ethernet_driver_frame_pool.h"
+#include "ethernet_driver_lease.h"
+#include "ethernet_driver_mac_filter.h"
+#include "ethernet_driver_netif_glue.h"
+#include "ethernet_driver_netstack.h"
+#include "ethernet_driver_phy_probe.h"
+#include "ethernet_driver_rx_filter.h"
+#include "ethernet_driver_rx_poll.h"
+#include "ethernet_driver_rx_task.h"
+#include "ethernet_driver_stats.h"
+#include "ethernet_driver_trace.h"
+#include "ethernet_driver_tx_sched.h"
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	#include "ethernet_driver_loopback.h"
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
 #if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
-	#define ETHERNET_DRIVER_CONFIG_INTERNAL_DEFAULT() \
-		{ .netif = NULL, .eth_mac = NULL, .eth_phy = NULL, .eth_handle = NULL, }
-/*
- .netif_config   = ESP_NETIF_DEFAULT_ETH(),  \
-			 .eth_mac_config = ETH_MAC_DEFAULT_CONFIG(), \
-			 .eth_phy_config = ETH_PHY_DEFAULT_CONFIG(), \
-			 */
+	#define ETHERNET_DRIVER_INTERNAL_ETHERNETS_NUM 1
+#else
+	#define ETHERNET_DRIVER_INTERNAL_ETHERNETS_NUM 0
 #endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
 
 #if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
-	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
-		#define ETHERNET_DRIVER_CONFIG_SPI_SPECIFIC                     \
-			{                                                           \
-				.mode = 0,                                              \
-				.clock_speed_hz =                                       \
-					CONFIG_ETHERNET_DRIVER_SPI_CLOCK_MHZ * 1000 * 1000, \
-				.queue_size = 20                                        \
-			}
+	#define ETHERNET_DRIVER_SPI_ETHERNETS_NUM \
+		CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM
+#else
+	#define ETHERNET_DRIVER_SPI_ETHERNETS_NUM 0
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	#define ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM \
+		CONFIG_ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM
+#else
+	#define ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM 0
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+#define ETHERNET_DRIVER_ETHERNETS_NUM                                     \
+	(ETHERNET_DRIVER_INTERNAL_ETHERNETS_NUM +                             \
+	 ETHERNET_DRIVER_SPI_ETHERNETS_NUM + ETHERNET_DRIVER_VIRTUAL_ETHERNETS_NUM)
+
+// Interface index used by the per-interface APIs, in initialization order
+#define ETHERNET_DRIVER_INTERNAL_INDEX 0
+#define ETHERNET_DRIVER_SPI_INDEX(num) \
+	(ETHERNET_DRIVER_INTERNAL_ETHERNETS_NUM + (num))
+#define ETHERNET_DRIVER_VIRTUAL_INDEX(num)                              \
+	(ETHERNET_DRIVER_INTERNAL_ETHERNETS_NUM +                           \
+	 ETHERNET_DRIVER_SPI_ETHERNETS_NUM + (num))
+
+#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+	#define ETHERNET_DRIVER_CONFIG_INTERNAL_DEFAULT()                   \
+		{                                                               \
+			.netif_base     = NULL,                                     \
+			.mdc_gpio       = CONFIG_ETHERNET_DRIVER_MDC_GPIO,          \
+			.mdio_gpio      = CONFIG_ETHERNET_DRIVER_MDIO_GPIO,         \
+			.phy_reset_gpio = CONFIG_ETHERNET_DRIVER_PHY_RST_GPIO,      \
+			.phy_addr       = CONFIG_ETHERNET_DRIVER_PHY_ADDR,          \
+			.eth_mac_config = ETH_MAC_DEFAULT_CONFIG(),                 \
+			.eth_phy_config = ETH_PHY_DEFAULT_CONFIG(),                 \
+			.rx_task        = ETHERNET_DRIVER_RX_TASK_CONFIG_DEFAULT(), \
+		}
+#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+	// SPI2 and SPI3, SPI1 is taken by the flash
+	#define ETHERNET_DRIVER_SPI_BUSES_MAX 2
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+		#define ETHERNET_DRIVER_SPI_RX_POLL_CONFIG_DEFAULT() \
+			.rx_poll_config = ETHERNET_DRIVER_RX_POLL_DEFAULT_CONFIG(),
+	#else
+		#define ETHERNET_DRIVER_SPI_RX_POLL_CONFIG_DEFAULT()
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+
+	#if CONFIG_ETHERNET_DRIVER_USE_W5500
+		#define ETHERNET_DRIVER_SPI_MODULE_DEFAULT_TYPE \
+			ETHERNET_DRIVER_SPI_MODULE_W5500
 	#elif CONFIG_ETHERNET_DRIVER_USE_DM9051
-		#define ETHERNET_DRIVER_CONFIG_SPI_SPECIFIC                     \
-			{                                                           \
-				.command_bits = 1, .address_bits = 7, .mode = 0,        \
-				.clock_speed_hz =                                       \
-					CONFIG_ETHERNET_DRIVER_SPI_CLOCK_MHZ * 1000 * 1000, \
-				.queue_size = 20                                        \
+		#define ETHERNET_DRIVER_SPI_MODULE_DEFAULT_TYPE \
+			ETHERNET_DRIVER_SPI_MODULE_DM9051
+	#else
+		#define ETHERNET_DRIVER_SPI_MODULE_DEFAULT_TYPE \
+			ETHERNET_DRIVER_SPI_MODULE_KSZ8851SNL
+	#endif
+
+	// Module from the Kconfig settings of SPI Ethernet module #num + 1
+	#define ETHERNET_DRIVER_SPI_MODULE_CONFIG_KCONFIG(num)                   \
+		{                                                                    \
+			.type           = ETHERNET_DRIVER_SPI_MODULE_DEFAULT_TYPE,       \
+			.spi_host       = CONFIG_ETHERNET_DRIVER_SPI_HOST,               \
+			.spi_cs_gpio    = CONFIG_ETHERNET_DRIVER_SPI_CS##num##_GPIO,     \
+			.int_gpio       = CONFIG_ETHERNET_DRIVER_SPI_INT##num##_GPIO,    \
+			.phy_reset_gpio = CONFIG_ETHERNET_DRIVER_SPI_PHY_RST##num##_GPIO, \
+			.phy_addr       = CONFIG_ETHERNET_DRIVER_SPI_PHY_ADDR##num,      \
+			.clock_speed_hz =                                                \
+				CONFIG_ETHERNET_DRIVER_SPI_CLOCK_MHZ * 1000 * 1000,          \
+			.rx_task = ETHERNET_DRIVER_RX_TASK_CONFIG_DEFAULT(),             \
+		}
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM > 1
+		#define ETHERNET_DRIVER_SPI_MODULES_KCONFIG_NUM 2
+		#define ETHERNET_DRIVER_SPI_MODULES_CONFIG_KCONFIG()   \
+			{                                                  \
+				ETHERNET_DRIVER_SPI_MODULE_CONFIG_KCONFIG(0),  \
+				ETHERNET_DRIVER_SPI_MODULE_CONFIG_KCONFIG(1),  \
 			}
-	#elif CONFIG_ETHERNET_DRIVER_USE_W5500
-		#define ETHERNET_DRIVER_CONFIG_SPI_SPECIFIC                     \
-			{                                                           \
-				.command_bits = 16, .address_bits = 8, .mode = 0,       \
-				.clock_speed_hz =                                       \
-					CONFIG_ETHERNET_DRIVER_SPI_CLOCK_MHZ * 1000 * 1000, \
-				.queue_size = 20, .flags = SPI_DEVICE_NO_DUMMY,         \
+	#else
+		#define ETHERNET_DRIVER_SPI_MODULES_KCONFIG_NUM 1
+		#define ETHERNET_DRIVER_SPI_MODULES_CONFIG_KCONFIG()   \
+			{                                                  \
+				ETHERNET_DRIVER_SPI_MODULE_CONFIG_KCONFIG(0),  \
 			}
 	#endif
 
-	#define ETHERNET_DRIVER_CONFIG_SPI_DEFAULT()                            \
-		{                                                                   \
-			.netif_config =                                                 \
-				{                                                           \
-					.base  = NULL,                                          \
-					.stack = ESP_NETIF_NETSTACK_DEFAULT_ETH,                \
-				},                                                          \
-			.netif =                                                        \
-				{                                                           \
-					NULL,                                                   \
-				},                                                          \
-			.device_handle =                                                \
-				{                                                           \
-					NULL,                                                   \
-				},                                                          \
-			.bus_config =                                                   \
-				{                                                           \
-					.miso_io_num   = CONFIG_ETHERNET_DRIVER_SPI_MISO_GPIO,  \
-					.mosi_io_num   = CONFIG_ETHERNET_DRIVER_SPI_MOSI_GPIO,  \
-					.sclk_io_num   = CONFIG_ETHERNET_DRIVER_SPI_SCLK_GPIO,  \
-					.quadwp_io_num = -1,                                    \
-					.quadhd_io_num = -1,                                    \
-				},                                                          \
-			.device_interface_config = ETHERNET_DRIVER_CONFIG_SPI_SPECIFIC, \
-			.eth_mac =                                                      \
-				{                                                           \
-					NULL,                                                   \
-				},                                                          \
-			.eth_phy =                                                      \
-				{                                                           \
-					NULL,                                                   \
-				},                                                          \
-			.eth_handle = {                                                 \
-				NULL,                                                       \
-			},                                                              \
+	#define ETHERNET_DRIVER_CONFIG_SPI_DEFAULT()                           \
+		{                                                                  \
+			.netif_base = NULL,                                            \
+			.bus_num    = 1,                                               \
+			.bus =                                                         \
+				{                                                          \
+					{                                                      \
+						.host = CONFIG_ETHERNET_DRIVER_SPI_HOST,           \
+						.bus_config =                                      \
+							{                                              \
+								.miso_io_num =                             \
+									CONFIG_ETHERNET_DRIVER_SPI_MISO_GPIO,  \
+								.mosi_io_num =                             \
+									CONFIG_ETHERNET_DRIVER_SPI_MOSI_GPIO,  \
+								.sclk_io_num =                             \
+									CONFIG_ETHERNET_DRIVER_SPI_SCLK_GPIO,  \
+								.quadwp_io_num = -1,                       \
+								.quadhd_io_num = -1,                       \
+							},                                             \
+					},                                                     \
+				},                                                         \
+			.module_num     = ETHERNET_DRIVER_SPI_MODULES_KCONFIG_NUM,     \
+			.module_config  = ETHERNET_DRIVER_SPI_MODULES_CONFIG_KCONFIG(), \
+			.eth_mac_config = ETH_MAC_DEFAULT_CONFIG(),                    \
+			.eth_phy_config = ETH_PHY_DEFAULT_CONFIG(),                    \
+			ETHERNET_DRIVER_SPI_RX_POLL_CONFIG_DEFAULT()                   \
 		}
-/*
- .netif_inherent_config = ESP_NETIF_INHERENT_DEFAULT_ETH(),      \
-			 .eth_mac_config          = ETH_MAC_DEFAULT_CONFIG(),            \
-			 .eth_phy_config = ETH_PHY_DEFAULT_CONFIG(), \
-			  */
-
-	#define INIT_SPI_ETHERNET_MODULE_CONFIG(spi_module_config, num) \
-		do {                                                        \
-			spi_module_config[num].spi_cs_gpio =                    \
-				CONFIG_ETHERNET_DRIVER_SPI_CS##num##_GPIO;          \
-			spi_module_config[num].int_gpio =                       \
-				CONFIG_ETHERNET_DRIVER_SPI_INT##num##_GPIO;         \
-			spi_module_config[num].phy_reset_gpio =                 \
-				CONFIG_ETHERNET_DRIVER_SPI_PHY_RST##num##_GPIO;     \
-			spi_module_config[num].phy_addr =                       \
-				CONFIG_ETHERNET_DRIVER_SPI_PHY_ADDR##num;           \
-		} while (0)
 #endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
 
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	#define ETHERNET_DRIVER_CONFIG_VIRTUAL_DEFAULT()                      \
+		{                                                                 \
+			.netif_base      = NULL,                                      \
+			.loopback_config = ETHERNET_DRIVER_LOOPBACK_DEFAULT_CONFIG(), \
+			.eth_mac_config  = ETH_MAC_DEFAULT_CONFIG(),                  \
+			.eth_phy_config  = ETH_PHY_DEFAULT_CONFIG(),                  \
+		}
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+	#define ETHERNET_DRIVER_CONFIG_INTERNAL_INIT() \
+		.internal_config = ETHERNET_DRIVER_CONFIG_INTERNAL_DEFAULT(),
+#else
+	#define ETHERNET_DRIVER_CONFIG_INTERNAL_INIT()
+#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+	#define ETHERNET_DRIVER_CONFIG_SPI_INIT() \
+		.spi_config = ETHERNET_DRIVER_CONFIG_SPI_DEFAULT(),
+#else
+	#define ETHERNET_DRIVER_CONFIG_SPI_INIT()
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	#define ETHERNET_DRIVER_CONFIG_VIRTUAL_INIT() \
+		.virtual_config = ETHERNET_DRIVER_CONFIG_VIRTUAL_DEFAULT(),
+#else
+	#define ETHERNET_DRIVER_CONFIG_VIRTUAL_INIT()
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+/**
+ * Every interface from the Kconfig settings, fit for
+ * static const ethernet_driver_config_t config = ...;
+ */
+#define ETHERNET_DRIVER_CONFIG_DEFAULT()      \
+	{                                         \
+		ETHERNET_DRIVER_CONFIG_INTERNAL_INIT() \
+		ETHERNET_DRIVER_CONFIG_SPI_INIT()      \
+		ETHERNET_DRIVER_CONFIG_VIRTUAL_INIT()  \
+	}
+
 #if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
 typedef struct ethernet_driver_internal_config_s {
-	esp_netif_config_t netif_config;
-	esp_netif_t       *netif;
-	eth_mac_config_t   eth_mac_config;
-	esp_eth_mac_t     *eth_mac;
-	eth_phy_config_t   eth_phy_config;
-	esp_eth_phy_t     *eth_phy;
-	esp_eth_config_t   eth_config;
-	esp_eth_handle_t   eth_handle;
+	// NULL for ESP_NETIF_BASE_DEFAULT_ETH
+	const esp_netif_inherent_config_t *netif_base;
+	// Over the SMI pins of eth_mac_config and the PHY of eth_phy_config
+	int8_t                             mdc_gpio;
+	int8_t                             mdio_gpio;
+	int8_t                             phy_reset_gpio;
+	int8_t                             phy_addr;
+	eth_mac_config_t                   eth_mac_config;
+	eth_phy_config_t                   eth_phy_config;
+	ethernet_driver_rx_task_config_t   rx_task;
 } ethernet_driver_internal_config_t;
 #endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
 
 #if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+typedef enum ethernet_driver_spi_module_type_e {
+	ETHERNET_DRIVER_SPI_MODULE_DM9051,
+	ETHERNET_DRIVER_SPI_MODULE_KSZ8851SNL,
+	ETHERNET_DRIVER_SPI_MODULE_W5500,
+} ethernet_driver_spi_module_type_t;
+
 typedef struct ethernet_driver_spi_module_config_s {
-	uint8_t spi_cs_gpio;
-	uint8_t int_gpio;
-	int8_t  phy_reset_gpio;
-	uint8_t phy_addr;
+	ethernet_driver_spi_module_type_t type;
+	spi_host_device_t                 spi_host;
+	int8_t                            spi_cs_gpio;
+	int8_t                            int_gpio; // -1 when not wired
+	int8_t                            phy_reset_gpio;
+	uint8_t                           phy_addr;
+	int                               clock_speed_hz;
+	// Over eth_mac_config, which all modules share
+	ethernet_driver_rx_task_config_t rx_task;
 } ethernet_driver_spi_module_config_t;
 
+typedef struct ethernet_driver_spi_bus_config_s {
+	spi_host_device_t host;
+	spi_bus_config_t  bus_config;
+} ethernet_driver_spi_bus_config_t;
+
 typedef struct ethernet_driver_spi_config_s {
-	esp_netif_inherent_config_t netif_inherent_config;
-	esp_netif_config_t          netif_config;
-	esp_netif_t				*netif[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
-	spi_device_handle_t device_handle[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
-	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
-	eth_ksz8851snl_config_t device_config;
-	#elif CONFIG_ETHERNET_DRIVER_USE_DM9051
-	eth_dm9051_config_t device_config;
-	#elif CONFIG_ETHERNET_DRIVER_USE_W5500
-	eth_w5500_config_t device_config;
-	#endif
-	spi_bus_config_t bus_config;
+	// NULL for ESP_NETIF_BASE_DEFAULT_ETH, key, description and route
+	// priority are set per module
+	const esp_netif_inherent_config_t *netif_base;
+	uint8_t                            bus_num;
+	ethernet_driver_spi_bus_config_t   bus[ETHERNET_DRIVER_SPI_BUSES_MAX];
+	// Modules in use, up to CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM
+	uint8_t module_num;
 	ethernet_driver_spi_module_config_t
 		module_config[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
-	spi_device_interface_config_t device_interface_config;
-	eth_mac_config_t              eth_mac_config;
-	esp_eth_mac_t   *eth_mac[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
+	eth_mac_config_t eth_mac_config;
 	eth_phy_config_t eth_phy_config;
-	esp_eth_phy_t   *eth_phy[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
-	esp_eth_config_t eth_config;
-	esp_eth_handle_t eth_handle[CONFIG_ETHERNET_DRIVER_SPI_ETHERNETS_NUM];
+	#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+	// Shared by all modules, the mode can be changed per interface later
+	ethernet_driver_rx_poll_config_t rx_poll_config;
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
 } ethernet_driver_spi_config_t;
 #endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
 
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+typedef struct ethernet_driver_virtual_config_s {
+	// NULL for ESP_NETIF_BASE_DEFAULT_ETH, key, description and route
+	// priority are set per interface
+	const esp_netif_inherent_config_t *netif_base;
+	// Its frame_pool is replaced by the driver's
+	ethernet_driver_loopback_config_t loopback_config;
+	eth_mac_config_t                  eth_mac_config;
+	eth_phy_config_t                  eth_phy_config;
+} ethernet_driver_virtual_config_t;
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+
+/**
+ * Description of every interface, only read during the init, so it can be
+ * a const in flash. The driver keeps the handles it creates itself.
+ */
 typedef struct ethernet_driver_config_s {
 #if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
 	ethernet_driver_internal_config_t internal_config;
@@ -197,12 +320,73 @@ typedef struct ethernet_driver_config_s {
 #if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
 	ethernet_driver_spi_config_t spi_config;
 #endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	ethernet_driver_virtual_config_t virtual_config;
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
 } ethernet_driver_config_t;
 
+/** Live handles of one interface, NULL where it has none */
+typedef struct ethernet_driver_handles_s {
+	esp_netif_t     *netif;
+	esp_eth_mac_t   *eth_mac;
+	esp_eth_phy_t   *eth_phy;
+	esp_eth_handle_t eth_handle; // NULL while its driver is not installed
+} ethernet_driver_handles_t;
+
+/** Static RAM the driver core keeps, besides what its modules allocate */
+typedef struct ethernet_driver_ram_usage_s {
+	uint32_t interfaces;      // ETHERNET_DRIVER_ETHERNETS_NUM
+	uint32_t interface_bytes; // Handle table entry of one interface
+	uint32_t static_bytes;    // Handle table, frame pools and SPI hosts
+	uint32_t config_bytes;    // ethernet_driver_config_t, in flash if const
+} ethernet_driver_ram_usage_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
-void ethernet_driver_init(ethernet_driver_config_t *config);
+/**
+ * config NULL brings up the interfaces of ETHERNET_DRIVER_CONFIG_DEFAULT().
+ * Aborts on a failed bring-up, ESP_ERR_INVALID_STATE when already done.
+ */
+esp_err_t ethernet_driver_init(const ethernet_driver_config_t *config);
+
+/**
+ * Create the netifs and SPI buses, then create the MAC and PHY of every
+ * interface and bring it up concurrently, one task each, without waiting
+ * for any of them. Readiness and failures are reported per interface
+ * through ready_cb and the event group of ethernet_driver_get_event_group().
+ * config is only read before it returns, NULL as for ethernet_driver_init().
+ * Errors of the shared part are returned with nothing left created,
+ * ESP_ERR_INVALID_STATE when the driver was already initialized.
+ */
+esp_err_t ethernet_driver_init_async(const ethernet_driver_config_t *config,
+									 ethernet_driver_ready_cb_t      ready_cb,
+									 void                           *arg);
+
+/**
+ * Stop every interface and release what the init created: drivers, MACs,
+ * PHYs, netifs, frame pools, SPI buses and the GPIO ISR service when it
+ * installed it. Not from the default event loop task, which has to handle
+ * the STOP events. ESP_ERR_INVALID_STATE while a bring-up task of
+ * ethernet_driver_init_async() still runs. When an interface can not be
+ * stopped its error is returned and the driver stays initialized.
+ */
+esp_err_t ethernet_driver_deinit(void);
+
+/**
+ * Stop interface index, uninstall its driver and install and start it
+ * again, which resets its PHY and chip. MAC, PHY and netif are kept and the
+ * other interfaces keep running. Not from the default event loop task.
+ * ESP_ERR_INVALID_STATE while its bring-up task still runs.
+ */
+esp_err_t ethernet_driver_restart(uint32_t index);
+
+/** ESP_ERR_INVALID_STATE for an index the init did not create */
+esp_err_t ethernet_driver_get_handles(uint32_t                   index,
+									  ethernet_driver_handles_t *handles);
+
+void ethernet_driver_get_ram_usage(ethernet_driver_ram_usage_t *usage);
+void ethernet_driver_print_ram_usage(void);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_balance.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#include "ethernet_driver.h"
+#include "ethernet_driver_netif_glue.h"
+
+#if CONFIG_ETHERNET_DRIVER_BALANCE
+// Members are the internal EMAC and the SPI modules, virtual ones never
+	#define ETHERNET_DRIVER_BALANCE_MEMBERS_NUM \
+		(ETHERNET_DRIVER_INTERNAL_ETHERNETS_NUM + \
+		 ETHERNET_DRIVER_SPI_ETHERNETS_NUM)
+
+/**
+ * Frames and bytes the balancer sent on each member, by interface index.
+ * Together with the tx counters of ethernet_driver_get_stats() they give
+ * the utilization of each link and the aggregate throughput.
+ */
+typedef struct ethernet_driver_balance_stats_s {
+	uint32_t up_mask; // Bit index set while the link of index is up
+	uint32_t tx_frames[ETHERNET_DRIVER_BALANCE_MEMBERS_NUM];
+	uint32_t tx_bytes[ETHERNET_DRIVER_BALANCE_MEMBERS_NUM];
+	uint32_t moved_frames; // Sent on another member than routed to
+	uint32_t unhashed;     // Not IPv4, sent where routed to
+	uint32_t rebalances;   // Changes of the set of links up
+} ethernet_driver_balance_stats_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+esp_err_t ethernet_driver_balance_get_stats(
+	ethernet_driver_balance_stats_t *stats);
+esp_err_t ethernet_driver_balance_reset_stats(void);
+
+// Used by the netif glue
+/**
+ * Balance over glue once its netif got ip_info. ESP_ERR_INVALID_STATE when
+ * the other members are on another subnet, balanced links must share one
+ * layer 2 segment.
+ */
+esp_err_t ethernet_driver_balance_add(ethernet_driver_netif_glue_handle_t glue,
+									  const esp_netif_ip_info_t *ip_info);
+/**
+ * Returns once no frame can be sent on glue anymore, so it can be freed.
+ * Must not be called from the tcpip thread.
+ */
+void ethernet_driver_balance_remove(ethernet_driver_netif_glue_handle_t glue);
+
+/**
+ * Member to send frame on instead of glue, by a hash of its IPv4 addresses
+ * and TCP/UDP ports over the members whose link is up, so a flow stays on
+ * one link. The source MAC of frame is rewritten to the chosen member's.
+ */
+ethernet_driver_netif_glue_handle_t ethernet_driver_balance_select(
+	ethernet_driver_netif_glue_handle_t glue, uint8_t *frame, size_t length);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_BALANCE
@@ -0,0 +1,230 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_benchmark.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "ethernet_driver.h"
+
+#if CONFIG_ETHERNET_DRIVER_BENCHMARK
+	#define ETHERNET_DRIVER_BENCHMARK_FRAME_SIZES_NUM 3
+
+	#define ETHERNET_DRIVER_BENCHMARK_CONFIG_DEFAULT()          \
+		{                                                       \
+			.frame_size = {64, 512, 1514},                      \
+			.frames     = CONFIG_ETHERNET_DRIVER_BENCHMARK_FRAMES, \
+			.timeout_ms = 10000,                                \
+		}
+
+typedef struct ethernet_driver_benchmark_config_s {
+	uint32_t frame_size[ETHERNET_DRIVER_BENCHMARK_FRAME_SIZES_NUM];
+	uint32_t frames;
+	uint32_t timeout_ms;
+} ethernet_driver_benchmark_config_t;
+
+typedef struct ethernet_driver_benchmark_result_s {
+	uint32_t frame_size;
+	uint32_t frames_sent;
+	uint32_t frames_received;
+	uint32_t tx_retries;
+	int64_t  duration_us;
+	uint32_t frames_per_sec;
+	uint32_t bytes_per_sec;
+	uint32_t latency_p50_us;
+	uint32_t latency_p99_us;
+	uint32_t heap_allocations_per_10k;
+	uint32_t rx_copied_bytes_per_frame;
+} ethernet_driver_benchmark_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Send frames of every configured size from the first virtual interface to
+ * the last one (or to itself when there is only one) and measure the path up
+ * to the netif, once the driver is initialized. results must hold
+ * ETHERNET_DRIVER_BENCHMARK_FRAME_SIZES_NUM entries.
+ */
+esp_err_t ethernet_driver_benchmark_run(
+	const ethernet_driver_benchmark_config_t *benchmark_config,
+	ethernet_driver_benchmark_result_t       *results);
+void ethernet_driver_benchmark_print(
+	const ethernet_driver_benchmark_result_t *results, size_t count);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_BENCHMARK
+	// Pure interrupt first, then hybrid
+	#define ETHERNET_DRIVER_BENCHMARK_RX_POLL_MODES_NUM 2
+
+typedef struct ethernet_driver_benchmark_rx_poll_result_s {
+	ethernet_driver_rx_poll_mode_t mode;
+	uint32_t                       frames_per_sec;
+	uint32_t                       bytes_per_sec;
+	uint32_t                       rx_dropped;
+	uint32_t                       cpu_load_percent;
+	uint32_t                       polled_frames;
+	uint32_t                       irq_to_poll;
+} ethernet_driver_benchmark_rx_poll_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Measure SPI interface index for duration_ms in each RX mode while an
+ * external generator floods it, e.g. with iperf or a UDP blaster. CPU load
+ * comes from the run time of the idle tasks. The interface is left in
+ * hybrid mode. results must hold ETHERNET_DRIVER_BENCHMARK_RX_POLL_MODES_NUM
+ * entries.
+ */
+esp_err_t ethernet_driver_benchmark_rx_poll_run(
+	uint32_t index, uint32_t duration_ms,
+	ethernet_driver_benchmark_rx_poll_result_t *results);
+void ethernet_driver_benchmark_rx_poll_print(
+	const ethernet_driver_benchmark_rx_poll_result_t *results, size_t count);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_RESTART_BENCHMARK
+typedef struct ethernet_driver_benchmark_restart_result_s {
+	uint32_t restarts; // Successful ones, the first is not measured
+	uint32_t failures;
+	uint32_t restart_min_us;
+	uint32_t restart_avg_us;
+	uint32_t restart_max_us;
+	int32_t  heap_lost; // Free heap lost over the run, 0 without leaks
+	uint32_t heap_min_free;
+} ethernet_driver_benchmark_restart_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Restart interface index restarts + 1 times, settle_ms apart so its events
+ * are handled. The free heap after the first restart, which allocates what
+ * lives on, is compared with the one after the last restart.
+ */
+esp_err_t ethernet_driver_benchmark_restart_run(
+	uint32_t index, uint32_t restarts, uint32_t settle_ms,
+	ethernet_driver_benchmark_restart_result_t *result);
+void ethernet_driver_benchmark_restart_print(
+	const ethernet_driver_benchmark_restart_result_t *result);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_RESTART_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_RX_FILTER_BENCHMARK
+typedef struct ethernet_driver_benchmark_rx_filter_result_s {
+	uint32_t frames;
+	uint32_t dropped;
+	uint32_t ns_per_frame;
+	uint32_t ns_per_frame_empty; // Same frames without rules
+} ethernet_driver_benchmark_rx_filter_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Set rules on interface index and classify a mix of broadcast ARP,
+ * multicast UDP and unicast TCP frames frames times, then again without
+ * rules. The rules of the interface are restored afterwards, with their
+ * hit counters reset. Its traffic is classified with the benchmark rules
+ * meanwhile, so an idle one is best.
+ */
+esp_err_t ethernet_driver_benchmark_rx_filter_run(
+	uint32_t index, const ethernet_driver_rx_filter_rule_t *rules,
+	size_t count, uint32_t frames,
+	ethernet_driver_benchmark_rx_filter_result_t *result);
+void ethernet_driver_benchmark_rx_filter_print(
+	const ethernet_driver_benchmark_rx_filter_result_t *result);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_RX_FILTER_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED_BENCHMARK
+typedef struct ethernet_driver_benchmark_tx_sched_result_s {
+	uint32_t                         bulk_frames; // Accepted by the queue
+	uint32_t                         control_frames;
+	ethernet_driver_tx_sched_stats_t stats;
+} ethernet_driver_benchmark_tx_sched_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Keep the bulk queue of interface index full with 1514 byte frames for
+ * duration_ms while a 64 byte control frame is sent every
+ * control_period_ms, both priority tagged to a locally administered
+ * address. Best run on a virtual interface or an isolated link.
+ */
+esp_err_t ethernet_driver_benchmark_tx_sched_run(
+	uint32_t index, uint32_t duration_ms, uint32_t control_period_ms,
+	ethernet_driver_benchmark_tx_sched_result_t *result);
+void ethernet_driver_benchmark_tx_sched_print(
+	const ethernet_driver_benchmark_tx_sched_result_t *result);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED_BENCHMARK
+
+#if CONFIG_ETHERNET_DRIVER_CHKSUM_BENCHMARK
+	#define ETHERNET_DRIVER_BENCHMARK_CHKSUM_LENGTHS_NUM 4
+
+typedef struct ethernet_driver_benchmark_chksum_result_s {
+	uint32_t length;
+	uint32_t ns_reference; // lwIP's default 16-bit loop
+	uint32_t ns_chksum;
+	uint32_t ns_copy_reference; // memcpy() then the 16-bit loop
+	uint32_t ns_copy;
+	uint32_t mismatches; // Of the alignments and odd lengths checked
+} ethernet_driver_benchmark_chksum_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Time ethernet_driver_chksum() and ethernet_driver_chksum_copy() against
+ * lwIP's default checksum on 20, 64, 576 and 1500 bytes at the 2-byte
+ * alignment of an IP header, iterations times each, after checking both
+ * agree with it at every alignment. results must hold
+ * ETHERNET_DRIVER_BENCHMARK_CHKSUM_LENGTHS_NUM entries.
+ */
+esp_err_t ethernet_driver_benchmark_chksum_run(
+	uint32_t iterations, ethernet_driver_benchmark_chksum_result_t *results);
+void ethernet_driver_benchmark_chksum_print(
+	const ethernet_driver_benchmark_chksum_result_t *results);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_CHKSUM_BENCHMARK
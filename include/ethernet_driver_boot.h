@@ -0,0 +1,76 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_boot.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_netif.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "sdkconfig.h"
+
+// Event group bits of interface index (see ETHERNET_DRIVER_*_INDEX)
+#define ETHERNET_DRIVER_LINK_UP_BIT(index) ((EventBits_t)1 << (index))
+#define ETHERNET_DRIVER_GOT_IP_BIT(index)  ((EventBits_t)1 << ((index) + 8))
+#define ETHERNET_DRIVER_FAILED_BIT(index)  ((EventBits_t)1 << ((index) + 16))
+
+/** Milliseconds from init to each milestone, -1 while not reached */
+typedef struct ethernet_driver_boot_trace_s {
+	int32_t   link_up_ms;
+	int32_t   got_ip_ms;
+	esp_err_t status;
+} ethernet_driver_boot_trace_t;
+
+/**
+ * Called once per interface when it first gets an IP address (status ESP_OK)
+ * or when its bring-up fails.
+ */
+typedef void (*ethernet_driver_ready_cb_t)(uint32_t index, esp_err_t status,
+										   void *arg);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/** Event group with the LINK_UP, GOT_IP and FAILED bits of each interface */
+EventGroupHandle_t ethernet_driver_get_event_group(void);
+
+esp_err_t ethernet_driver_get_boot_trace(uint32_t                      index,
+										 ethernet_driver_boot_trace_t *trace);
+void      ethernet_driver_print_boot_trace(void);
+
+// Used by ethernet_driver_init() and ethernet_driver_init_async()
+esp_err_t ethernet_driver_boot_start(ethernet_driver_ready_cb_t ready_cb,
+									 void                      *arg);
+void      ethernet_driver_boot_register(uint32_t index, esp_netif_t *netif,
+										esp_eth_handle_t eth_handle);
+void      ethernet_driver_boot_failed(uint32_t index, esp_err_t status);
+
+/** Index of the interface of netif or eth_handle, ETHERNETS_NUM if none */
+uint32_t ethernet_driver_boot_find_index(esp_netif_t     *netif,
+										 esp_eth_handle_t eth_handle);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_capture.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_CAPTURE
+	#define ETHERNET_DRIVER_CAPTURE_RING_SIZE \
+		(1U << CONFIG_ETHERNET_DRIVER_CAPTURE_RING_LOG2)
+
+// pcap file header, written once before the records
+	#define ETHERNET_DRIVER_CAPTURE_HEADER_LEN 24
+// pcap record header, in front of the captured bytes of each frame
+	#define ETHERNET_DRIVER_CAPTURE_RECORD_HEADER_LEN 16
+
+	#define ETHERNET_DRIVER_CAPTURE_RX (1U << 0)
+	#define ETHERNET_DRIVER_CAPTURE_TX (1U << 1)
+
+	#define ETHERNET_DRIVER_CAPTURE_FILTER_DEFAULT()                        \
+		{                                                                   \
+			.index_mask = UINT32_MAX,                                       \
+			.directions = ETHERNET_DRIVER_CAPTURE_RX |                      \
+						  ETHERNET_DRIVER_CAPTURE_TX,                       \
+			.ethertype  = 0,                                                \
+			.snaplen    = CONFIG_ETHERNET_DRIVER_CAPTURE_SNAPLEN,           \
+		}
+
+/**
+ * Frames of the interfaces in index_mask, in the given directions and with
+ * ethertype (0 for any, the one inside a VLAN tag counts) are captured. The
+ * first snaplen bytes of each are kept.
+ */
+typedef struct ethernet_driver_capture_filter_s {
+	uint32_t index_mask; // Bit index set to capture interface index
+	uint32_t directions; // ETHERNET_DRIVER_CAPTURE_RX and/or _TX
+	uint16_t ethertype;
+	uint32_t snaplen;
+} ethernet_driver_capture_filter_t;
+
+typedef struct ethernet_driver_capture_stats_s {
+	uint32_t captured;
+	uint32_t truncated; // Captured with less than their length
+	uint32_t filtered;  // Seen while running, not matching the filter
+	uint32_t dropped;   // Ring was full
+	uint32_t ring_used; // Bytes not read yet
+} ethernet_driver_capture_stats_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Start capturing into the ring, which keeps what was not read before.
+ * ESP_ERR_INVALID_ARG when a record of snaplen bytes does not fit in the
+ * ring, ESP_ERR_INVALID_STATE while running.
+ */
+esp_err_t ethernet_driver_capture_start(
+	const ethernet_driver_capture_filter_t *filter);
+esp_err_t ethernet_driver_capture_stop(void);
+
+esp_err_t ethernet_driver_capture_get_stats(
+	ethernet_driver_capture_stats_t *stats);
+esp_err_t ethernet_driver_capture_reset_stats(void);
+
+/**
+ * pcap file header of Ethernet frames truncated to the snaplen of the
+ * running or last capture, ETHERNET_DRIVER_CAPTURE_HEADER_LEN bytes.
+ */
+void ethernet_driver_capture_header(void *header);
+
+/**
+ * Move whole records not read yet, oldest first, into buffer. *length is
+ * set to the bytes moved, 0 when the ring is empty or the next record does
+ * not fit. Behind ethernet_driver_capture_header() they form a pcap file.
+ */
+esp_err_t ethernet_driver_capture_read(void *buffer, size_t size,
+									   size_t *length);
+
+/**
+ * Write the pcap header and every record not read yet to file, for example
+ * one on a host build or an SD card. Capture may keep running.
+ */
+esp_err_t ethernet_driver_capture_dump(FILE *file);
+
+// Used by the netif glue, returns at once while not capturing
+void ethernet_driver_capture_frame(uint32_t index, uint32_t direction,
+								   const uint8_t *frame, size_t length);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_CAPTURE
@@ -0,0 +1,50 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_chksum.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_CHKSUM
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Internet checksum of length bytes at data, folded but not complemented,
+ * like lwip_standard_chksum(). Force-included into lwIP as LWIP_CHKSUM.
+ */
+uint16_t ethernet_driver_chksum(const void *data, int length);
+
+/**
+ * Copy length bytes from src to dst and return their checksum, in one pass
+ * when both are equally aligned. lwIP's LWIP_CHKSUM_COPY, used when
+ * LWIP_CHECKSUM_ON_COPY is enabled.
+ */
+uint16_t ethernet_driver_chksum_copy(void *dst, const void *src,
+									 uint16_t length);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_CHKSUM
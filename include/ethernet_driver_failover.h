@@ -0,0 +1,65 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_failover.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_FAILOVER
+// Bucket i counts failovers faster than 2^i ms, the last one the rest
+	#define ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS 12
+
+/**
+ * Latency runs from the last PHY poll that still saw the link up to the
+ * default route being moved, an upper bound of the outage.
+ */
+typedef struct ethernet_driver_failover_stats_s {
+	uint32_t failovers;
+	uint32_t failbacks;
+	uint32_t no_survivor; // Default interface lost with no other one up
+	uint32_t latency_ms[ETHERNET_DRIVER_FAILOVER_LATENCY_BUCKETS];
+} ethernet_driver_failover_stats_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+esp_err_t ethernet_driver_failover_get_stats(
+	ethernet_driver_failover_stats_t *stats);
+esp_err_t ethernet_driver_failover_reset_stats(void);
+
+/**
+ * Watch interface index. Must be called before the driver is installed
+ * from phy, eth_handle is read once it is.
+ */
+esp_err_t ethernet_driver_failover_attach(uint32_t index, esp_netif_t *netif,
+										  esp_eth_phy_t    *phy,
+										  esp_eth_handle_t *eth_handle);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_FAILOVER
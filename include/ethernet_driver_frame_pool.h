@@ -0,0 +1,84 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_frame_pool.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	// Bytes reserved in front of every buffer for the netstack bookkeeping
+	#define ETHERNET_DRIVER_FRAME_POOL_HEADROOM 64
+
+typedef struct ethernet_driver_frame_pool_stats_s {
+	uint32_t capacity;
+	uint32_t in_use;
+	uint32_t high_water_mark;
+	uint32_t allocations;
+	uint32_t exhausted;
+} ethernet_driver_frame_pool_stats_t;
+
+typedef struct ethernet_driver_frame_pool_s {
+	uint8_t                           *arena;
+	uint16_t                          *free_list;
+	uint32_t                           free_count;
+	uint32_t                           buffer_size;
+	uint32_t                           stride;
+	bool                               released;
+	portMUX_TYPE                       lock;
+	ethernet_driver_frame_pool_stats_t stats;
+} ethernet_driver_frame_pool_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+esp_err_t ethernet_driver_frame_pool_new(uint32_t buffer_count,
+										 uint32_t buffer_size,
+										 ethernet_driver_frame_pool_t **out);
+
+/**
+ * Release the pool. Buffers lwIP still holds stay valid, the memory is
+ * freed when the last of them is returned.
+ */
+void ethernet_driver_frame_pool_del(ethernet_driver_frame_pool_t *pool);
+
+/** Take a buffer from the pool, NULL when the pool is exhausted */
+uint8_t *ethernet_driver_frame_pool_alloc(ethernet_driver_frame_pool_t *pool);
+void     ethernet_driver_frame_pool_free(ethernet_driver_frame_pool_t *pool,
+										 void                         *buffer);
+bool     ethernet_driver_frame_pool_owns(
+	const ethernet_driver_frame_pool_t *pool, const void *buffer);
+
+void ethernet_driver_frame_pool_get_stats(
+	ethernet_driver_frame_pool_t       *pool,
+	ethernet_driver_frame_pool_stats_t *stats);
+void ethernet_driver_frame_pool_reset_stats(
+	ethernet_driver_frame_pool_t *pool);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
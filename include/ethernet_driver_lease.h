@@ -0,0 +1,90 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_lease.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_LEASE_CACHE
+/** Last DHCP lease and link of one interface, addresses in network order */
+typedef struct ethernet_driver_lease_s {
+	uint32_t ip;
+	uint32_t netmask;
+	uint32_t gw;
+	uint32_t dns[2];
+	uint32_t lease_time_s;
+	uint8_t  speed;  // eth_speed_t
+	uint8_t  duplex; // eth_duplex_t
+} ethernet_driver_lease_t;
+
+/** How the address of the current link was obtained */
+typedef enum {
+	ETHERNET_DRIVER_LEASE_NONE,      // No usable cached lease, full DHCP
+	ETHERNET_DRIVER_LEASE_REBOOTING, // INIT-REBOOT of the cached address
+	ETHERNET_DRIVER_LEASE_REUSED,    // Cached address confirmed
+	ETHERNET_DRIVER_LEASE_NEW,       // Address differs from the cached one
+} ethernet_driver_lease_state_t;
+
+/**
+ * Storage of the cached leases, NVS by default. load returns
+ * ESP_ERR_NOT_FOUND when index has no lease. Host builds can plug in a
+ * stand-in to measure time-to-IP without flash.
+ */
+typedef struct ethernet_driver_lease_store_s {
+	esp_err_t (*load)(uint32_t index, ethernet_driver_lease_t *lease,
+					  void *arg);
+	esp_err_t (*save)(uint32_t index, const ethernet_driver_lease_t *lease,
+					  void *arg);
+	esp_err_t (*erase)(uint32_t index, void *arg);
+	void *arg;
+} ethernet_driver_lease_store_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/** Replace the lease storage before init, NULL restores NVS */
+esp_err_t ethernet_driver_lease_set_store(
+	const ethernet_driver_lease_store_t *store);
+
+/** Lease of interface index (see ETHERNET_DRIVER_*_INDEX) */
+esp_err_t ethernet_driver_lease_get(uint32_t                       index,
+									ethernet_driver_lease_t       *lease,
+									ethernet_driver_lease_state_t *state);
+/** Forget the lease of interface index, the next link up runs full DHCP */
+esp_err_t ethernet_driver_lease_erase(uint32_t index);
+
+// Used by the netif glue, after esp-netif handled the event
+void ethernet_driver_lease_link_up(uint32_t index, esp_netif_t *netif,
+								   esp_eth_handle_t eth_handle);
+void ethernet_driver_lease_got_ip(uint32_t index, esp_netif_t *netif,
+								  esp_eth_handle_t           eth_handle,
+								  const esp_netif_ip_info_t *ip_info);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_LEASE_CACHE
@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_loopback.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_eth.h"
+#include "sdkconfig.h"
+
+#include "ethernet_driver_frame_pool.h"
+
+#if CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
+	#define ETHERNET_DRIVER_LOOPBACK_DEFAULT_CONFIG() \
+		{ .rx_queue_len = CONFIG_ETHERNET_DRIVER_VIRTUAL_RX_QUEUE_LEN, }
+
+typedef struct ethernet_driver_loopback_config_s {
+	uint32_t rx_queue_len;
+	#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+	ethernet_driver_frame_pool_t *frame_pool; // NULL allocates from the heap
+	#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+} ethernet_driver_loopback_config_t;
+
+/** Receive-side probe used to measure RX-to-netif latency */
+typedef struct ethernet_driver_loopback_probe_s {
+	uint32_t         *latency_us;
+	uint32_t          capacity;
+	volatile uint32_t count;
+	volatile uint32_t heap_allocations;
+	int64_t           first_rx_us;
+	int64_t           last_rx_us;
+} ethernet_driver_loopback_probe_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+esp_eth_mac_t *ethernet_driver_loopback_mac_new(
+	const ethernet_driver_loopback_config_t *loopback_config,
+	const eth_mac_config_t                  *mac_config);
+esp_eth_phy_t *ethernet_driver_loopback_phy_new(
+	const eth_phy_config_t *phy_config);
+
+esp_err_t ethernet_driver_loopback_connect(esp_eth_mac_t *mac_a,
+										   esp_eth_mac_t *mac_b);
+esp_err_t ethernet_driver_loopback_phy_set_link(esp_eth_phy_t *phy,
+												eth_link_t     link);
+esp_err_t ethernet_driver_loopback_set_probe(
+	esp_eth_mac_t *mac, ethernet_driver_loopback_probe_t *probe);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_USE_VIRTUAL_ETHERNET
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_mac_filter.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_MAC_FILTER
+	#define ETHERNET_DRIVER_MAC_FILTER_DEFAULT_CONFIG() \
+		{                                               \
+			.promiscuous   = false,                     \
+			.broadcast     = true,                      \
+			.all_multicast = false,                     \
+		}
+
+typedef struct ethernet_driver_mac_filter_config_s {
+	bool promiscuous;   // Accept every frame, the chip filter included
+	bool broadcast;     // Accept broadcast frames
+	bool all_multicast; // Accept every multicast, not only the groups
+} ethernet_driver_mac_filter_config_t;
+
+typedef struct ethernet_driver_mac_filter_stats_s {
+	uint32_t groups;
+	// Hash table programmed on the chip, 0 when it has none
+	uint32_t multicast_hash[2];
+	// Broadcast and multicast the filter rejects that were still read
+	uint32_t unwanted_frames;
+	uint32_t unwanted_bytes;
+	/**
+	 * Bytes the chip filter kept off the bus, estimated from the unwanted
+	 * bytes per second while it was open, before the filter was set or in
+	 * promiscuous mode. saved_spi_us is their time at the SPI clock.
+	 */
+	uint64_t saved_bytes;
+	uint64_t saved_spi_us;
+} ethernet_driver_mac_filter_stats_t;
+
+// Filter registers of a chip, chosen by the driver for each MAC
+typedef struct ethernet_driver_mac_filter_chip_s
+	ethernet_driver_mac_filter_chip_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+	#if CONFIG_ETHERNET_DRIVER_USE_DM9051
+extern const ethernet_driver_mac_filter_chip_t
+	ethernet_driver_mac_filter_dm9051;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_DM9051
+	#if CONFIG_ETHERNET_DRIVER_USE_W5500
+extern const ethernet_driver_mac_filter_chip_t ethernet_driver_mac_filter_w5500;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_W5500
+	#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+extern const ethernet_driver_mac_filter_chip_t
+	ethernet_driver_mac_filter_ksz8851;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+	#if CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+extern const ethernet_driver_mac_filter_chip_t ethernet_driver_mac_filter_esp32;
+	#endif // CONFIG_ETHERNET_DRIVER_USE_INTERNAL_ETHERNET
+
+/**
+ * Filter destination addresses of interface index in the chip. From
+ * ESP-IDF 5.3 the driver programs promiscuous mode, the groups and
+ * all-multicast, broadcast can not be rejected. Before, promiscuous mode
+ * is set through the driver, broadcast and multicast in the filter
+ * registers of the chip. Interfaces without them return
+ * ESP_ERR_NOT_SUPPORTED unless broadcast and every multicast are accepted.
+ * Every frame is accepted until this is called.
+ */
+esp_err_t ethernet_driver_mac_filter_set(
+	uint32_t index, const ethernet_driver_mac_filter_config_t *config);
+
+/**
+ * Accept or stop accepting multicast mac. The groups lwIP joins with IGMP
+ * and MLD are added and removed on their own, counted apart from these.
+ * Hash tables also pass the other groups sharing a bit, the W5500 and the
+ * EMAC have none before ESP-IDF 5.3 and pass every multicast once a group
+ * is added.
+ */
+esp_err_t ethernet_driver_mac_filter_add(uint32_t index, const uint8_t *mac);
+esp_err_t ethernet_driver_mac_filter_del(uint32_t index, const uint8_t *mac);
+
+esp_err_t ethernet_driver_mac_filter_get_stats(
+	uint32_t index, ethernet_driver_mac_filter_stats_t *stats);
+
+// Used by the driver and the netif glue
+esp_err_t ethernet_driver_mac_filter_attach(
+	uint32_t index, esp_eth_mac_t *mac,
+	const ethernet_driver_mac_filter_chip_t *chip);
+void ethernet_driver_mac_filter_detach(uint32_t index);
+void ethernet_driver_mac_filter_start(uint32_t index, esp_netif_t *netif,
+									  esp_eth_handle_t eth_handle);
+void ethernet_driver_mac_filter_count(uint32_t index, const uint8_t *frame,
+									  size_t length);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_MAC_FILTER
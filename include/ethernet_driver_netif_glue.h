@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_netif_glue.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#include "ethernet_driver_stats.h"
+#include "ethernet_driver_tx_queue.h"
+#include "ethernet_driver_tx_sched.h"
+
+typedef struct ethernet_driver_netif_glue_s {
+	esp_netif_driver_base_t        base;
+	esp_eth_handle_t               eth_handle;
+	uint32_t                       index;
+	ethernet_driver_stats_handle_t stats;
+	esp_event_handler_instance_t   start_handler;
+	esp_event_handler_instance_t   stop_handler;
+	esp_event_handler_instance_t   connected_handler;
+	esp_event_handler_instance_t   disconnected_handler;
+	esp_event_handler_instance_t   got_ip_handler;
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+	// SPI interfaces only, NULL sends from the caller's task
+	ethernet_driver_tx_queue_handle_t tx_queue;
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+	ethernet_driver_tx_sched_handle_t tx_sched;
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
+} ethernet_driver_netif_glue_t;
+
+typedef ethernet_driver_netif_glue_t *ethernet_driver_netif_glue_handle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * Replacement for esp_eth_new_netif_glue(). Received frames go straight to
+ * the component netstack, so the esp-netif must be created with
+ * ETHERNET_DRIVER_NETSTACK_DEFAULT_ETH and bound before it is attached.
+ * index selects the statistics block of the interface.
+ */
+ethernet_driver_netif_glue_handle_t ethernet_driver_netif_glue_new(
+	esp_eth_handle_t eth_handle, uint32_t index);
+esp_err_t ethernet_driver_netif_glue_del(
+	ethernet_driver_netif_glue_handle_t glue);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_netstack.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#include "ethernet_driver_frame_pool.h"
+
+#define ETHERNET_DRIVER_NETSTACK_DEFAULT_ETH \
+	ethernet_driver_netstack_default_eth
+
+/** Bytes memcpy'd between the MAC driver and lwIP */
+typedef struct ethernet_driver_netstack_stats_s {
+	uint32_t rx_frames;
+	uint64_t rx_copied_bytes;
+	uint32_t tx_frames;
+	uint64_t tx_copied_bytes;
+} ethernet_driver_netstack_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * lwIP Ethernet netstack that wraps the driver RX buffers in custom pbufs
+ * instead of copying them, and flattens chained TX pbufs into pool buffers
+ * when the frame pool is enabled.
+ */
+extern const esp_netif_netstack_config_t *ethernet_driver_netstack_default_eth;
+
+/** Register an esp-netif created with ETHERNET_DRIVER_NETSTACK_DEFAULT_ETH */
+esp_err_t ethernet_driver_netstack_bind(esp_netif_t *netif);
+/** Release the binding of netif, lwIP must have freed its RX pbufs */
+void      ethernet_driver_netstack_unbind(esp_netif_t *netif);
+#if CONFIG_ETHERNET_DRIVER_FRAME_POOL
+esp_err_t ethernet_driver_netstack_set_frame_pool(
+	esp_netif_t *netif, ethernet_driver_frame_pool_t *frame_pool);
+#endif // CONFIG_ETHERNET_DRIVER_FRAME_POOL
+
+/**
+ * Pass a received frame to lwIP. The netstack takes ownership of buffer and
+ * returns an error when the frame was dropped.
+ */
+esp_err_t ethernet_driver_netstack_input(esp_netif_t *netif, uint8_t *buffer,
+										 uint32_t length);
+void      ethernet_driver_netstack_free_rx_buffer(esp_netif_t *netif,
+												  void        *buffer);
+
+// Keep the pbuf passed as netstack_buffer to transmit_wrap past the call
+void ethernet_driver_netstack_tx_ref(void *netstack_buffer);
+void ethernet_driver_netstack_tx_unref(void *netstack_buffer);
+
+esp_err_t ethernet_driver_netstack_get_stats(
+	esp_netif_t *netif, ethernet_driver_netstack_stats_t *stats);
+esp_err_t ethernet_driver_netstack_reset_stats(esp_netif_t *netif);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_phy_probe.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_PHY_AUTO
+/** What the probe of the internal EMAC found */
+typedef struct ethernet_driver_phy_probe_result_s {
+	const char *name; // Model family, NULL until the driver is installed
+	uint32_t    addr;
+	uint32_t    oui;      // As esp-eth reads it from PHYIDR1 and PHYIDR2
+	uint32_t    probe_us; // From the reset pulse to the match
+	uint32_t    reads;    // MDIO reads it took
+	bool        cached;   // Found at the address of the previous boot
+} ethernet_driver_phy_probe_result_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * PHY that scans the MDIO bus when the driver is installed and hands every
+ * call on to the esp_eth_phy_new_*() PHY whose OUI it found. phy_addr is
+ * tried right after the address cached by the previous boot.
+ */
+esp_eth_phy_t *ethernet_driver_phy_probe_new(
+	const eth_phy_config_t *phy_config);
+
+esp_err_t ethernet_driver_phy_probe_get_result(
+	esp_eth_phy_t *phy, ethernet_driver_phy_probe_result_t *result);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_PHY_AUTO
@@ -0,0 +1,95 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_rx_filter.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_RX_FILTER
+	#define ETHERNET_DRIVER_RX_FILTER_RULES \
+		CONFIG_ETHERNET_DRIVER_RX_FILTER_RULES
+
+	// Destination MAC classes, a rule matches any of the classes set
+	#define ETHERNET_DRIVER_RX_FILTER_DST_UNICAST   (1 << 0)
+	#define ETHERNET_DRIVER_RX_FILTER_DST_MULTICAST (1 << 1)
+	#define ETHERNET_DRIVER_RX_FILTER_DST_BROADCAST (1 << 2)
+
+typedef enum ethernet_driver_rx_filter_action_e {
+	ETHERNET_DRIVER_RX_FILTER_PASS,  // Hand to the stack, stop evaluating
+	ETHERNET_DRIVER_RX_FILTER_DROP,  // Drop, stop evaluating
+	ETHERNET_DRIVER_RX_FILTER_COUNT, // Only count, go on evaluating
+} ethernet_driver_rx_filter_action_t;
+
+/**
+ * Fields left 0 match anything. ip_proto or a port range make the rule
+ * IPv4 only, a port range matches the TCP/UDP destination port of the
+ * first fragment.
+ */
+typedef struct ethernet_driver_rx_filter_rule_s {
+	uint16_t                           ethertype;
+	uint8_t                            dst_class; // RX_FILTER_DST_* bits
+	uint8_t                            ip_proto;
+	uint16_t                           port_min;
+	uint16_t                           port_max;
+	ethernet_driver_rx_filter_action_t action;
+} ethernet_driver_rx_filter_rule_t;
+
+typedef struct ethernet_driver_rx_filter_stats_s {
+	uint32_t classified; // Frames evaluated against a non empty table
+	uint32_t dropped;
+	uint32_t hits[ETHERNET_DRIVER_RX_FILTER_RULES];
+} ethernet_driver_rx_filter_stats_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Replace the rules of interface index, evaluated in order on every frame
+ * right after the driver read it. Frames no rule passes or drops go to the
+ * stack. count 0 removes the rules. Hit counters are reset.
+ */
+esp_err_t ethernet_driver_rx_filter_set(
+	uint32_t index, const ethernet_driver_rx_filter_rule_t *rules,
+	size_t count);
+/**
+ * Copy the rules of interface index, rules holds
+ * ETHERNET_DRIVER_RX_FILTER_RULES of them.
+ */
+esp_err_t ethernet_driver_rx_filter_get(
+	uint32_t index, ethernet_driver_rx_filter_rule_t *rules, size_t *count);
+esp_err_t ethernet_driver_rx_filter_get_stats(
+	uint32_t index, ethernet_driver_rx_filter_stats_t *stats);
+esp_err_t ethernet_driver_rx_filter_reset_stats(uint32_t index);
+
+// Used by the netif glue, false when frame is to be dropped
+bool ethernet_driver_rx_filter_accept(uint32_t index, const uint8_t *frame,
+									  size_t length);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_RX_FILTER
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_rx_poll.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
+	#define ETHERNET_DRIVER_RX_POLL_DEFAULT_CONFIG()                       \
+		{                                                                  \
+			.mode         = ETHERNET_DRIVER_RX_POLL_MODE_HYBRID,           \
+			.enter_frames = CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_ENTER_FRAMES, \
+			.window_ms    = CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_WINDOW_MS,  \
+			.period_ms    = CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_PERIOD_MS,  \
+			.budget       = CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_BUDGET,     \
+			.idle_passes  = CONFIG_ETHERNET_DRIVER_SPI_RX_POLL_IDLE_PASSES, \
+		}
+
+typedef enum ethernet_driver_rx_poll_mode_e {
+	// Every frame is fetched by the MAC driver on its interrupt
+	ETHERNET_DRIVER_RX_POLL_MODE_IRQ,
+	// Interrupt while traffic is light, masked IRQ and polling under load
+	ETHERNET_DRIVER_RX_POLL_MODE_HYBRID,
+} ethernet_driver_rx_poll_mode_t;
+
+/**
+ * Polling starts once enter_frames frames arrive within window_ms. Each
+ * pass hands up to budget frames to the stack, passes are period_ms apart
+ * unless the budget ran out. The interrupt is unmasked after idle_passes
+ * empty passes with the interrupt line released.
+ */
+typedef struct ethernet_driver_rx_poll_config_s {
+	ethernet_driver_rx_poll_mode_t mode;
+	uint32_t                       enter_frames;
+	uint32_t                       window_ms;
+	uint32_t                       period_ms;
+	uint32_t                       budget;
+	uint32_t                       idle_passes;
+} ethernet_driver_rx_poll_config_t;
+
+typedef struct ethernet_driver_rx_poll_stats_s {
+	uint32_t irq_frames;
+	uint32_t polled_frames;
+	uint32_t poll_passes;
+	uint32_t irq_to_poll;
+	uint32_t poll_to_irq;
+	bool     polling;
+} ethernet_driver_rx_poll_stats_t;
+
+/**
+ * Frames waiting in the chip, for chips whose receive expects a frame to be
+ * there. NULL when the receive reads the RX size itself and comes back
+ * empty, as for the W5500 (Sn_RX_RSR) and the DM9051 (MRCMDX).
+ */
+typedef esp_err_t (*ethernet_driver_rx_poll_pending_t)(esp_eth_mac_t *mac,
+													   uint32_t *frames);
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/** Switch the RX mode of SPI interface index (see ETHERNET_DRIVER_*_INDEX) */
+esp_err_t ethernet_driver_rx_poll_set_mode(
+	uint32_t index, ethernet_driver_rx_poll_mode_t mode);
+esp_err_t ethernet_driver_rx_poll_get_stats(
+	uint32_t index, ethernet_driver_rx_poll_stats_t *stats);
+esp_err_t ethernet_driver_rx_poll_reset_stats(uint32_t index);
+
+/**
+ * Take over the RX of the MAC of SPI module num, whose interrupt line is
+ * int_gpio asserted at int_active_level, modules without one can not be
+ * polled. Must be called before the driver is installed. The poll task
+ * runs with the RX task settings of mac_config.
+ */
+esp_err_t ethernet_driver_rx_poll_attach(
+	uint32_t num, esp_eth_mac_t *mac, int int_gpio, int int_active_level,
+	ethernet_driver_rx_poll_pending_t       pending,
+	const ethernet_driver_rx_poll_config_t *config,
+	const eth_mac_config_t                 *mac_config);
+
+		#if CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+/**
+ * Acknowledge the RX interrupt of a KSZ8851SNL and read the frame count it
+ * latches, through the register accessors of its MAC.
+ */
+esp_err_t ethernet_driver_rx_poll_pending_ksz8851(esp_eth_mac_t *mac,
+												  uint32_t      *frames);
+		#endif // CONFIG_ETHERNET_DRIVER_USE_KSZ8851SNL
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_SPI_RX_POLL
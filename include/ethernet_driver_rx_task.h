@@ -0,0 +1,94 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_rx_task.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "sdkconfig.h"
+
+#define ETHERNET_DRIVER_RX_TASK_CONFIG_DEFAULT()                      \
+	{ .pin_to_core = false, .core = 0, .prio = 0, .stack_size = 0, }
+
+/**
+ * RX task of one interface, applied over the eth_mac_config its MAC is
+ * created with, so a zeroed one changes nothing. Without pin_to_core the
+ * ETH_MAC_FLAG_PIN_TO_CORE setting is kept, prio and stack_size 0 keep
+ * rx_task_prio and rx_task_stack_size.
+ */
+typedef struct ethernet_driver_rx_task_config_s {
+	bool     pin_to_core;
+	uint8_t  core;
+	uint8_t  prio;
+	uint32_t stack_size;
+} ethernet_driver_rx_task_config_t;
+
+#if CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+/**
+ * The RX task is the one frames of the interface are delivered from, known
+ * once the first frame arrived. cpu_permille is of one core, over the time
+ * since the task was first seen or the last reset. Read them before the
+ * task has run for another 71 minutes, when its 32 bit counter wraps twice.
+ */
+typedef struct ethernet_driver_rx_task_stats_s {
+	int32_t  core; // tskNO_AFFINITY when not pinned
+	uint32_t prio;
+	uint32_t stack_free; // Least free stack ever, bytes
+	uint64_t run_time_us;
+	uint64_t elapsed_us;
+	uint32_t cpu_permille;
+} ethernet_driver_rx_task_stats_t;
+#endif // CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/** Copy of mac_config with rx_task applied, used for each interface */
+void ethernet_driver_rx_task_mac_config(
+	const ethernet_driver_rx_task_config_t *rx_task,
+	const eth_mac_config_t *mac_config, eth_mac_config_t *rx_mac_config);
+
+/**
+ * Run fn in a task pinned to the core of rx_task, or right away when it is
+ * not pinned. MAC constructors pin their RX task to the core they run on.
+ */
+esp_err_t ethernet_driver_rx_task_run(
+	const ethernet_driver_rx_task_config_t *rx_task, void (*fn)(void *arg),
+	void *arg);
+
+#if CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+esp_err_t ethernet_driver_rx_task_get_stats(
+	uint32_t index, ethernet_driver_rx_task_stats_t *stats);
+esp_err_t ethernet_driver_rx_task_reset_stats(uint32_t index);
+
+// Used by the netif glue, from the task frames of interface index arrive in
+void ethernet_driver_rx_task_seen(uint32_t index);
+// Used by the netif glue once no more frames arrive
+void ethernet_driver_rx_task_forget(uint32_t index);
+#endif // CONFIG_ETHERNET_DRIVER_RX_TASK_STATS
+#ifdef __cplusplus
+}
+#endif
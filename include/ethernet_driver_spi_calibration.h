@@ -0,0 +1,57 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_spi_calibration.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "ethernet_driver.h"
+
+#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Find the SPI clock of module num. Starting at the configured clock, the
+ * clock is stepped up while the chip ID reads back and a write/read pattern
+ * on scratch registers survives, then the margin is taken off the fastest
+ * verified clock. The SPI bus must be initialized and the chip out of reset.
+ * Returns an error and leaves clock_speed_hz alone when even the configured
+ * clock fails.
+ */
+esp_err_t ethernet_driver_spi_calibrate(
+	uint32_t num, const ethernet_driver_spi_module_config_t *module_config,
+	const spi_device_interface_config_t *device_interface_config,
+	int                                 *clock_speed_hz);
+
+	#if CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+/** Forget the cached clock of module num, e.g. after a hardware change */
+esp_err_t ethernet_driver_spi_calibration_erase(uint32_t num);
+	#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION_NVS
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_SPI_CLOCK_CALIBRATION
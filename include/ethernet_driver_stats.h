@@ -0,0 +1,93 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_stats.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+	#include "driver/spi_master.h"
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+
+// Bucket i counts RX hand-offs faster than 2^i us, the last one the rest
+#define ETHERNET_DRIVER_STATS_LATENCY_BUCKETS 12
+
+/**
+ * Snapshot of the counters of one interface. Counters are 32 bits wide and
+ * wrap around, telemetry is expected to work with deltas.
+ */
+typedef struct ethernet_driver_stats_s {
+	uint32_t rx_frames;
+	uint32_t rx_bytes;
+	uint32_t rx_dropped;
+	uint32_t tx_frames;
+	uint32_t tx_bytes;
+	uint32_t tx_dropped;
+	uint32_t spi_transactions;
+	uint32_t spi_time_us;
+	uint32_t link_flaps;
+	uint32_t spi_clock_hz; // SPI interfaces only, after calibration if any
+	uint32_t rx_latency_us[ETHERNET_DRIVER_STATS_LATENCY_BUCKETS];
+} ethernet_driver_stats_t;
+
+typedef struct ethernet_driver_stats_block_s *ethernet_driver_stats_handle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * Read the counters of interface index (see ETHERNET_DRIVER_*_INDEX). Every
+ * counter is read atomically, the snapshot as a whole is not.
+ */
+esp_err_t ethernet_driver_get_stats(uint32_t                 index,
+									ethernet_driver_stats_t *stats);
+esp_err_t ethernet_driver_reset_stats(uint32_t index);
+
+/** Counter block of interface index, NULL when out of range */
+ethernet_driver_stats_handle_t ethernet_driver_stats_get_handle(
+	uint32_t index);
+
+// Hot path updates, relaxed atomics. A NULL handle is ignored.
+void ethernet_driver_stats_rx(ethernet_driver_stats_handle_t stats,
+							  uint32_t bytes, uint32_t latency_us);
+void ethernet_driver_stats_rx_dropped(ethernet_driver_stats_handle_t stats);
+void ethernet_driver_stats_tx(ethernet_driver_stats_handle_t stats,
+							  uint32_t                       bytes);
+void ethernet_driver_stats_tx_dropped(ethernet_driver_stats_handle_t stats);
+void ethernet_driver_stats_link_flap(ethernet_driver_stats_handle_t stats);
+
+#if CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+/**
+ * Install pre_cb/post_cb on the SPI device configuration of SPI module num
+ * so its transactions are counted and timed, and record its clock. Must be
+ * called before the MAC is created from device_interface_config.
+ */
+esp_err_t ethernet_driver_stats_hook_spi(
+	uint32_t num, spi_device_interface_config_t *device_interface_config);
+#endif // CONFIG_ETHERNET_DRIVER_USE_SPI_ETHERNET
+#ifdef __cplusplus
+}
+#endif
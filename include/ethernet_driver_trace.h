@@ -0,0 +1,88 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_trace.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_TRACE
+	#define ETHERNET_DRIVER_TRACE_RECORDS \
+		(1U << CONFIG_ETHERNET_DRIVER_TRACE_RECORDS_LOG2)
+
+typedef enum ethernet_driver_trace_id_e {
+	ETHERNET_DRIVER_TRACE_START,           // No data
+	ETHERNET_DRIVER_TRACE_STOP,            // No data
+	ETHERNET_DRIVER_TRACE_LINK_UP,         // data.mac
+	ETHERNET_DRIVER_TRACE_LINK_DOWN,       // No data
+	ETHERNET_DRIVER_TRACE_GOT_IP,          // data.ip: address, netmask, gw
+	ETHERNET_DRIVER_TRACE_RX_BURST,        // data.value: frames of a poll
+	ETHERNET_DRIVER_TRACE_TX_BURST,        // data.value: frames of a burst
+	ETHERNET_DRIVER_TRACE_SPI_TRANSACTION, // data.value: duration (us)
+	ETHERNET_DRIVER_TRACE_ID_MAX,
+} ethernet_driver_trace_id_t;
+
+/** 20 bytes, addresses kept in network byte order */
+typedef struct ethernet_driver_trace_record_s {
+	uint32_t timestamp_us;
+	uint8_t  index; // Interface index, ETHERNET_DRIVER_ETHERNETS_NUM if unknown
+	uint8_t  id;    // ethernet_driver_trace_id_t
+	union {
+		uint8_t  mac[6];
+		uint32_t ip[3];
+		uint32_t value;
+	} data;
+} ethernet_driver_trace_record_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Append a record, copying up to 12 bytes of data. Lock-free and callable
+ * from ISRs, the oldest records are overwritten once the ring is full.
+ */
+void ethernet_driver_trace_write(uint32_t index, ethernet_driver_trace_id_t id,
+								 const void *data, size_t size);
+
+/**
+ * Move up to max records not read yet, oldest first, into records. Records
+ * overwritten before being read are added to lost when not NULL.
+ */
+size_t ethernet_driver_trace_read(ethernet_driver_trace_record_t *records,
+								  size_t max, uint32_t *lost);
+
+/** Format a record with LOGI */
+void ethernet_driver_trace_print(const ethernet_driver_trace_record_t *record);
+
+/** Read and print every record not read yet */
+void ethernet_driver_trace_dump(void);
+
+// Used by ethernet_driver_init() and ethernet_driver_init_async()
+esp_err_t ethernet_driver_trace_init(void);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_TRACE
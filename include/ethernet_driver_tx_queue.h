@@ -0,0 +1,75 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_tx_queue.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
+typedef struct ethernet_driver_tx_queue_stats_s {
+	uint32_t depth;
+	uint32_t queued_frames;
+	uint32_t bursts;
+	uint32_t max_burst;
+	uint32_t full_waits;
+	uint32_t copied_frames;
+} ethernet_driver_tx_queue_stats_t;
+
+typedef struct ethernet_driver_tx_queue_s *ethernet_driver_tx_queue_handle_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Number of frames of SPI interface index (see ETHERNET_DRIVER_*_INDEX)
+ * that may wait for the TX task, 1 to
+ * CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE_MAX_DEPTH. Lowering it waits until
+ * enough queued frames are sent.
+ */
+esp_err_t ethernet_driver_tx_queue_set_depth(uint32_t index, uint32_t depth);
+esp_err_t ethernet_driver_tx_queue_get_stats(
+	uint32_t index, ethernet_driver_tx_queue_stats_t *stats);
+
+// Used by the netif glue of the SPI interfaces
+ethernet_driver_tx_queue_handle_t ethernet_driver_tx_queue_new(
+	esp_eth_handle_t eth_handle, uint32_t index);
+esp_err_t ethernet_driver_tx_queue_del(
+	ethernet_driver_tx_queue_handle_t tx_queue);
+
+/**
+ * Queue a frame, blocking while the queue is at its depth. netstack_buffer
+ * is the lwIP pbuf holding buffer, which is referenced until the frame is
+ * sent. Without it buffer is copied.
+ */
+esp_err_t ethernet_driver_tx_queue_send(
+	ethernet_driver_tx_queue_handle_t tx_queue, void *buffer, size_t length,
+	void *netstack_buffer);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_SPI_TX_QUEUE
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_tx_sched.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_eth.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ETHERNET_DRIVER_TX_SCHED
+	#define ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM \
+		CONFIG_ETHERNET_DRIVER_TX_SCHED_QUEUES
+
+// Served first, ARP and DSCP CS5 and above or VLAN PCP 5 and above
+	#define ETHERNET_DRIVER_TX_SCHED_CONTROL 0
+// Everything not classified otherwise
+	#define ETHERNET_DRIVER_TX_SCHED_DEFAULT 1
+// Served last and rate capped, DSCP CS1 and LE or VLAN PCP 1
+	#define ETHERNET_DRIVER_TX_SCHED_BULK \
+		(ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM - 1)
+
+// Bucket i counts frames sent within 32 << i us, the last one the rest
+	#define ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS 14
+
+/**
+ * Latency runs from the frame being queued to esp_eth_transmit() having
+ * returned, so it includes the transfer to the chip.
+ */
+typedef struct ethernet_driver_tx_sched_queue_stats_s {
+	uint32_t depth;
+	uint32_t pending;
+	uint32_t sent_frames;
+	uint32_t sent_bytes;
+	uint32_t dropped; // Queue was at its depth
+	uint32_t max_latency_us;
+	uint32_t latency_us[ETHERNET_DRIVER_TX_SCHED_LATENCY_BUCKETS];
+} ethernet_driver_tx_sched_queue_stats_t;
+
+typedef struct ethernet_driver_tx_sched_stats_s {
+	uint32_t bulk_rate_kbps;
+	uint32_t throttled; // Times the rate cap held the bulk queue back
+	uint32_t bursts;
+	uint32_t max_burst;
+	uint32_t copied_frames;
+	ethernet_driver_tx_sched_queue_stats_t
+		queues[ETHERNET_DRIVER_TX_SCHED_QUEUES_NUM];
+} ethernet_driver_tx_sched_stats_t;
+
+typedef struct ethernet_driver_tx_sched_s *ethernet_driver_tx_sched_handle_t;
+
+	#ifdef __cplusplus
+extern "C" {
+	#endif
+/**
+ * Queue of interface index (see ETHERNET_DRIVER_*_INDEX) that frames with
+ * DSCP dscp, or a VLAN tag with PCP pcp, are sent from. The PCP of a tagged
+ * frame wins over the DSCP inside it. Sockets mark their frames with
+ * setsockopt(IP_TOS), e.g. 0xB8 for EF.
+ */
+esp_err_t ethernet_driver_tx_sched_map_dscp(uint32_t index, uint8_t dscp,
+											uint32_t queue);
+esp_err_t ethernet_driver_tx_sched_map_pcp(uint32_t index, uint8_t pcp,
+										   uint32_t queue);
+
+/**
+ * Number of frames queue of interface index may hold, 1 to
+ * CONFIG_ETHERNET_DRIVER_TX_SCHED_MAX_DEPTH. Frames beyond it are dropped,
+ * so a full bulk queue never blocks lwIP from queueing control frames.
+ */
+esp_err_t ethernet_driver_tx_sched_set_depth(uint32_t index, uint32_t queue,
+											 uint32_t depth);
+
+// Rate of the bulk queue of interface index in kbit/s, 0 leaves it uncapped
+esp_err_t ethernet_driver_tx_sched_set_bulk_rate(uint32_t index,
+												 uint32_t rate_kbps);
+
+esp_err_t ethernet_driver_tx_sched_get_stats(
+	uint32_t index, ethernet_driver_tx_sched_stats_t *stats);
+esp_err_t ethernet_driver_tx_sched_reset_stats(uint32_t index);
+
+// Used by the netif glue and the benchmark
+ethernet_driver_tx_sched_handle_t ethernet_driver_tx_sched_new(
+	esp_eth_handle_t eth_handle, uint32_t index);
+esp_err_t ethernet_driver_tx_sched_del(
+	ethernet_driver_tx_sched_handle_t tx_sched);
+ethernet_driver_tx_sched_handle_t ethernet_driver_tx_sched_get(
+	uint32_t index);
+
+/**
+ * Classify a frame and queue it, ESP_ERR_NO_MEM when its queue is full.
+ * netstack_buffer is the lwIP pbuf holding buffer, which is referenced
+ * until the frame is sent. Without it buffer is copied.
+ */
+esp_err_t ethernet_driver_tx_sched_send(
+	ethernet_driver_tx_sched_handle_t tx_sched, void *buffer, size_t length,
+	void *netstack_buffer);
+	#ifdef __cplusplus
+}
+	#endif
+#endif // CONFIG_ETHERNET_DRIVER_TX_SCHED
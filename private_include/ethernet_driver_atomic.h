@@ -0,0 +1,43 @@
+/**
+ * Copyright 2023 Legytma Soluções Inteligentes LTDA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ethernet_driver_atomic.h
+ *
+ *  Created on: 17 de out de 2026
+ *      Author: Alex Manoel Ferreira Silva
+ */
+
+#pragma once
+
+#include <stdatomic.h>
+
+/**
+ * Relaxed access to counters and values read on their own, whose order
+ * with other memory does not matter. Anything published to another task
+ * uses the explicit orders instead.
+ */
+#define RELAXED_ADD(object, value) \
+	atomic_fetch_add_explicit(&(object), (value), memory_order_relaxed)
+#define RELAXED_SUB(object, value) \
+	atomic_fetch_sub_explicit(&(object), (value), memory_order_relaxed)
+#define RELAXED_LOAD(object) \
+	atomic_load_explicit(&(object), memory_order_relaxed)
+#define RELAXED_STORE(object, value) \
+	atomic_store_explicit(&(object), (value), memory_order_relaxed)
+#define RELAXED_EXCHANGE(object, value) \
+	atomic_exchange_explicit(&(object), (value), memory_order_relaxed)
+#define RELAXED_CLEAR(object) RELAXED_STORE(object, 0)